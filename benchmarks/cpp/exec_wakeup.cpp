@@ -0,0 +1,139 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/experimental/channel.hpp>
+
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/* Wake-up micro benchmark.
+ *
+ * Simulates the load of test_conn_echo_stress without a Redis
+ * server: a number of sessions wait for the response of their
+ * request, the reader wakes them up in FIFO order and each
+ * session immediately waits for the next one. Compares the timer
+ * that expires at time_point::max and is cancelled on completion,
+ * which async_exec used before, with the single slot channel it
+ * uses now.
+ */
+
+namespace net = boost::asio;
+using boost::system::error_code;
+using clock_type = std::chrono::steady_clock;
+using executor_type = net::io_context::executor_type;
+
+class timer_event {
+public:
+   explicit timer_event(executor_type ex)
+   : timer_{ex}
+   {
+      timer_.expires_at((clock_type::time_point::max)());
+   }
+
+   template <class Handler>
+   void async_wait(Handler h) { timer_.async_wait(std::move(h)); }
+
+   void notify() { timer_.cancel(); }
+
+private:
+   net::basic_waitable_timer<clock_type, net::wait_traits<clock_type>, executor_type> timer_;
+};
+
+class channel_event {
+public:
+   explicit channel_event(executor_type ex)
+   : channel_{ex, 1}
+   { }
+
+   template <class Handler>
+   void async_wait(Handler h) { channel_.async_receive(std::move(h)); }
+
+   void notify() { channel_.try_send(error_code{}); }
+
+private:
+   net::experimental::channel<executor_type, void(error_code)> channel_;
+};
+
+template <class Event>
+class driver {
+public:
+   driver(executor_type ex, int sessions, int repeat)
+   : ex_{ex}
+   , total_{sessions * repeat}
+   {
+      for (int i = 0; i < sessions; ++i)
+         events_.push_back(std::make_unique<Event>(ex));
+   }
+
+   void start()
+   {
+      for (auto& e: events_)
+         wait(e.get());
+
+      net::post(ex_, [this]() { read(); });
+   }
+
+private:
+   void wait(Event* e)
+   {
+      pending_.push_back(e);
+      e->async_wait([this, e](error_code) {
+         if (++completed_ + static_cast<int>(std::size(pending_)) < total_)
+            wait(e);
+      });
+   }
+
+   // Mimics the reader, which wakes up one exec per response.
+   void read()
+   {
+      if (!pending_.empty()) {
+         pending_.front()->notify();
+         pending_.pop_front();
+      }
+
+      if (completed_ < total_)
+         net::post(ex_, [this]() { read(); });
+   }
+
+   executor_type ex_;
+   int total_;
+   int completed_ = 0;
+   std::vector<std::unique_ptr<Event>> events_;
+   std::deque<Event*> pending_;
+};
+
+template <class Event>
+void measure(std::string_view name, int sessions, int repeat)
+{
+   net::io_context ioc;
+   driver<Event> d{ioc.get_executor(), sessions, repeat};
+
+   auto const begin = clock_type::now();
+   d.start();
+   ioc.run();
+   std::chrono::duration<double> const elapsed = clock_type::now() - begin;
+
+   auto const rate = sessions * repeat / elapsed.count() / 1e6;
+   std::cout << "   " << name << ": " << rate << " M wake-ups/s" << std::endl;
+}
+
+int main()
+{
+   int const total = 2'000'000;
+
+   for (int sessions : {1, 100, 1000}) {
+      std::cout << "Sessions: " << sessions << std::endl;
+      measure<timer_event>("timer", sessions, total / sessions);
+      measure<channel_event>("channel", sessions, total / sessions);
+   }
+}
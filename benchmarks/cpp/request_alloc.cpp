@@ -0,0 +1,126 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/request.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* Request allocation benchmark.
+ *
+ * Counts the heap allocations made when building short-lived
+ * requests, one per RPC, comparing a new request each time with
+ * requests that take their storage from a per-thread pool of
+ * buffers and give it back with request::release_buffer.
+ */
+
+using boost::redis::request;
+using clock_type = std::chrono::steady_clock;
+
+std::size_t allocations = 0;
+
+void* operator new(std::size_t size)
+{
+   ++allocations;
+   if (auto* p = std::malloc(size == 0 ? 1 : size))
+      return p;
+
+   throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+   std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+   std::free(p);
+}
+
+// A per-thread pool of request buffers.
+auto get_pool() -> std::vector<std::string>&
+{
+   thread_local std::vector<std::string> pool;
+   return pool;
+}
+
+auto acquire_buffer() -> std::string
+{
+   auto& pool = get_pool();
+   if (pool.empty())
+      return {};
+
+   auto buffer = std::move(pool.back());
+   pool.pop_back();
+   return buffer;
+}
+
+void release_buffer(request& req)
+{
+   get_pool().push_back(req.release_buffer());
+}
+
+// A typical RPC with a key and a value larger than the small string
+// buffer.
+void fill(request& req, int i)
+{
+   req.push("HSET", "session:12345678", "field", i, "value", std::string_view{"a value that does not fit in sso"});
+   req.push("EXPIRE", "session:12345678", 3600);
+}
+
+template <class F>
+void measure(std::string_view name, int repeat, F f)
+{
+   std::size_t sink = 0;
+   auto const before = allocations;
+   auto const begin = clock_type::now();
+   for (int i = 0; i < repeat; ++i)
+      sink += f(i);
+   std::chrono::duration<double> const elapsed = clock_type::now() - begin;
+
+   auto const n = allocations - before;
+   std::cout
+      << name << ": "
+      << static_cast<double>(n) / repeat << " allocations/request, "
+      << elapsed.count() / repeat * 1e9 << " ns/request ("
+      << sink << ")" << std::endl;
+}
+
+int main()
+{
+   int const repeat = 1000000;
+
+   measure("   new request", repeat, [](int i)
+   {
+      request req;
+      fill(req, i);
+      return req.payload().size();
+   });
+
+   measure("   reserved request", repeat, [](int i)
+   {
+      request req;
+      req.reserve(256);
+      fill(req, i);
+      return req.payload().size();
+   });
+
+   measure("   pooled buffer", repeat, [](int i)
+   {
+      request req;
+      req.set_buffer(acquire_buffer());
+      fill(req, i);
+      auto const size = req.payload().size();
+      release_buffer(req);
+      return size;
+   });
+}
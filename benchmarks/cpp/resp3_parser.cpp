@@ -0,0 +1,151 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/resp3/parser.hpp>
+#include <boost/redis/adapter/adapt.hpp>
+#include <boost/redis/ignore.hpp>
+#include <boost/redis/detail/number.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* Parser micro benchmark.
+ *
+ * Measures the separator scan in isolation, comparing
+ * std::string_view::find with the vectorized scanner used by the
+ * parser, and the throughput of parsing a large aggregate made of
+ * small elements e.g. the reply to MGET or HGETALL. Also compares
+ * std::from_chars with the decoders used for lengths and doubles.
+ */
+
+namespace resp3 = boost::redis::resp3;
+using boost::system::error_code;
+using clock_type = std::chrono::steady_clock;
+
+// An array with n bulk strings of size len.
+auto make_aggregate(std::size_t n, std::size_t len)
+{
+   std::string const value(len, 'a');
+
+   std::string wire = "*" + std::to_string(n) + "\r\n";
+   for (std::size_t i = 0; i < n; ++i) {
+      wire += "$" + std::to_string(len) + "\r\n";
+      wire += value;
+      wire += "\r\n";
+   }
+
+   return wire;
+}
+
+// Reports the best of a few rounds to reduce noise.
+template <class F>
+auto measure(std::string_view name, std::size_t bytes, int repeat, F f)
+{
+   std::size_t sink = 0;
+   double best = 0;
+   for (int round = 0; round < 5; ++round) {
+      auto const begin = clock_type::now();
+      for (int i = 0; i < repeat; ++i)
+         sink += f();
+      std::chrono::duration<double> const elapsed = clock_type::now() - begin;
+
+      auto const mbps = static_cast<double>(bytes) * repeat / elapsed.count() / 1e6;
+      best = (std::max)(best, mbps);
+   }
+
+   std::cout << name << ": " << best << " MB/s (" << sink << ")" << std::endl;
+}
+
+// Decodes all numbers in the list with f.
+template <class T, class F>
+void measure_numbers(std::string_view name, std::vector<std::string> const& numbers, F f)
+{
+   std::size_t bytes = 0;
+   for (auto const& n: numbers)
+      bytes += n.size();
+
+   measure(name, bytes, 50, [&]()
+   {
+      T sum{};
+      for (std::string_view n: numbers) {
+         T value{};
+         f(value, n);
+         sum += value;
+      }
+
+      return static_cast<std::size_t>(sum);
+   });
+}
+
+void measure_numbers()
+{
+   std::vector<std::string> lengths;
+   std::vector<std::string> doubles;
+   for (std::size_t i = 0; i < 100000; ++i) {
+      lengths.push_back(std::to_string(i % 1000));
+      doubles.push_back(std::to_string(static_cast<double>(i) / 7));
+   }
+
+   std::cout << "Numbers" << std::endl;
+
+   measure_numbers<std::size_t>("   from_chars (length)", lengths, [](auto& value, std::string_view n)
+      { std::from_chars(n.data(), n.data() + n.size(), value); });
+
+   measure_numbers<std::size_t>("   parse_integer (length)", lengths, [](auto& value, std::string_view n)
+      { boost::redis::detail::parse_integer(value, n); });
+
+#ifndef _LIBCPP_VERSION
+   measure_numbers<double>("   from_chars (double)", doubles, [](auto& value, std::string_view n)
+      { std::from_chars(n.data(), n.data() + n.size(), value); });
+#endif
+
+   measure_numbers<double>("   parse_double (double)", doubles, [](auto& value, std::string_view n)
+      { boost::redis::detail::parse_double(value, n); });
+}
+
+int main()
+{
+   int const repeat = 50;
+
+   measure_numbers();
+
+   for (std::size_t len : {8, 64, 512}) {
+      auto const wire = make_aggregate(50000, len);
+      std::string_view const view{wire};
+
+      std::cout << "Elements of size " << len << ", message of " << wire.size() << " bytes" << std::endl;
+
+      measure("   string_view::find", wire.size(), repeat, [&]()
+      {
+         std::size_t n = 0;
+         for (auto pos = view.find("\r\n"); pos != std::string_view::npos; pos = view.find("\r\n", pos + 2))
+            ++n;
+         return n;
+      });
+
+      measure("   find_separator", wire.size(), repeat, [&]()
+      {
+         std::size_t n = 0;
+         for (auto pos = resp3::detail::find_separator(view, 0); pos != std::string_view::npos; pos = resp3::detail::find_separator(view, pos + 2))
+            ++n;
+         return n;
+      });
+
+      measure("   parse", wire.size(), repeat, [&]()
+      {
+         resp3::parser p;
+         boost::redis::adapter::ignore adapter;
+         error_code ec;
+         resp3::parse(p, view, adapter, ec);
+         return p.get_consumed();
+      });
+   }
+}
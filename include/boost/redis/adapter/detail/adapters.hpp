@@ -8,9 +8,12 @@
 #define BOOST_REDIS_ADAPTER_ADAPTERS_HPP
 
 #include <boost/redis/error.hpp>
+#include <boost/redis/detail/number.hpp>
 #include <boost/redis/resp3/type.hpp>
 #include <boost/redis/resp3/serialization.hpp>
 #include <boost/redis/resp3/node.hpp>
+#include <boost/redis/resp3/flat_tree.hpp>
+#include <boost/redis/resp3/node_queue.hpp>
 #include <boost/redis/adapter/result.hpp>
 #include <boost/assert.hpp>
 
@@ -26,14 +29,26 @@
 #include <vector>
 #include <array>
 #include <string_view>
-#include <charconv>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
-// See https://stackoverflow.com/a/31658120/1077832
-#include<ciso646>
-#ifdef _LIBCPP_VERSION
-#else
-#include <cstdlib>
-#endif
+namespace boost::redis
+{
+
+/** @brief Reads a struct field by field from a map, see `push_struct`.
+ *  @ingroup high-level-api
+ *
+ *  Specialize it to derive from `std::true_type` for structs
+ *  described with Boost.Describe that are read from e.g. the reply
+ *  to `HGETALL`. Reading them requires `boost/redis/describe.hpp`.
+ *  Other types are read from a single bulk string with
+ *  `boost_redis_from_bulk`.
+ */
+template <class T>
+struct is_described_struct : std::false_type {};
+
+} // boost::redis
 
 namespace boost::redis::adapter::detail
 {
@@ -43,8 +58,7 @@ namespace boost::redis::adapter::detail
 template <class T>
 auto boost_redis_from_bulk(T& i, std::string_view sv, system::error_code& ec) -> typename std::enable_if<std::is_integral<T>::value, void>::type
 {
-   auto const res = std::from_chars(sv.data(), sv.data() + std::size(sv), i);
-   if (res.ec != std::errc())
+   if (!redis::detail::parse_integer(i, sv))
       ec = redis::error::not_a_number;
 }
 
@@ -57,20 +71,8 @@ void boost_redis_from_bulk(bool& t, std::string_view sv, system::error_code&)
 inline
 void boost_redis_from_bulk(double& d, std::string_view sv, system::error_code& ec)
 {
-#ifdef _LIBCPP_VERSION
-   // The string in sv is not null terminated and we also don't know
-   // if there is enough space at the end for a null char. The easiest
-   // thing to do is to create a temporary.
-   std::string const tmp{sv.data(), sv.data() + std::size(sv)};
-   char* end{};
-   d = std::strtod(tmp.data(), &end);
-   if (d == HUGE_VAL || d == 0)
-      ec = redis::error::not_a_double;
-#else
-   auto const res = std::from_chars(sv.data(), sv.data() + std::size(sv), d);
-   if (res.ec != std::errc())
+   if (!redis::detail::parse_double(d, sv))
       ec = redis::error::not_a_double;
-#endif // _LIBCPP_VERSION
 }
 
 template <class CharT, class Traits, class Allocator>
@@ -83,6 +85,19 @@ boost_redis_from_bulk(
   s.append(sv.data(), sv.size());
 }
 
+// Creates an element that uses the allocator of the container it is
+// going to be inserted into, e.g. a std::pmr::string in a
+// std::pmr::vector, so that moving it into the container does not
+// copy.
+template <class T, class Container, class... Args>
+auto make_element(Container const& c, Args&&... args) -> T
+{
+   if constexpr (std::uses_allocator_v<T, typename Container::allocator_type>)
+      return T(std::forward<Args>(args)..., c.get_allocator());
+   else
+      return T(std::forward<Args>(args)...);
+}
+
 //================================================
 
 template <class Result>
@@ -94,6 +109,33 @@ public:
    explicit general_aggregate(Result* c = nullptr): result_(c) {}
    template <class String>
    void operator()(resp3::basic_node<String> const& nd, system::error_code&)
+   {
+      using string_type = decltype(Result::value_type::value_type::value);
+
+      BOOST_ASSERT_MSG(!!result_, "Unexpected null pointer");
+      switch (nd.data_type) {
+         case resp3::type::blob_error:
+         case resp3::type::simple_error:
+            *result_ = error{nd.data_type, std::string{std::cbegin(nd.value), std::cend(nd.value)}};
+            break;
+         default:
+         {
+            auto& nodes = result_->value();
+            nodes.push_back({nd.data_type, nd.aggregate_size, nd.depth, make_element<string_type>(nodes, nd.value.data(), nd.value.size())});
+         }
+      }
+   }
+};
+
+template <class Result>
+class general_flat_aggregate {
+private:
+   Result* result_;
+
+public:
+   explicit general_flat_aggregate(Result* c = nullptr): result_(c) {}
+   template <class String>
+   void operator()(resp3::basic_node<String> const& nd, system::error_code&)
    {
       BOOST_ASSERT_MSG(!!result_, "Unexpected null pointer");
       switch (nd.data_type) {
@@ -102,7 +144,29 @@ public:
             *result_ = error{nd.data_type, std::string{std::cbegin(nd.value), std::cend(nd.value)}};
             break;
          default:
-            result_->value().push_back({nd.data_type, nd.aggregate_size, nd.depth, std::string{std::cbegin(nd.value), std::cend(nd.value)}});
+            result_->value().push_back({nd.data_type, nd.aggregate_size, nd.depth, std::string_view{nd.value}});
+      }
+   }
+};
+
+template <class Result>
+class general_queue_aggregate {
+private:
+   Result* result_;
+
+public:
+   explicit general_queue_aggregate(Result* c = nullptr): result_(c) {}
+   template <class String>
+   void operator()(resp3::basic_node<String> const& nd, system::error_code&)
+   {
+      BOOST_ASSERT_MSG(!!result_, "Unexpected null pointer");
+      switch (nd.data_type) {
+         case resp3::type::blob_error:
+         case resp3::type::simple_error:
+            *result_ = error{nd.data_type, std::string{std::cbegin(nd.value), std::cend(nd.value)}};
+            break;
+         default:
+            result_->value().push_back(nd);
       }
    }
 };
@@ -175,7 +239,7 @@ public:
 	 return;
       }
 
-      typename Result::key_type obj;
+      auto obj = make_element<typename Result::key_type>(result);
       boost_redis_from_bulk(obj, nd.value, ec);
       hint_ = result.insert(hint_, std::move(obj));
    }
@@ -208,11 +272,11 @@ public:
       }
 
       if (on_key_) {
-         typename Result::key_type obj;
+         auto obj = make_element<typename Result::key_type>(result);
          boost_redis_from_bulk(obj, nd.value, ec);
-         current_ = result.insert(current_, {std::move(obj), {}});
+         current_ = result.emplace_hint(current_, std::move(obj), make_element<typename Result::mapped_type>(result));
       } else {
-         typename Result::mapped_type obj;
+         auto obj = make_element<typename Result::mapped_type>(result);
          boost_redis_from_bulk(obj, nd.value, ec);
          current_->second = std::move(obj);
       }
@@ -233,7 +297,9 @@ public:
          auto const m = element_multiplicity(nd.data_type);
          result.reserve(result.size() + m * nd.aggregate_size);
       } else {
-         result.push_back({});
+         // Constructs in place so that the element uses the
+         // allocator of the container.
+         result.emplace_back();
          boost_redis_from_bulk(result.back(), nd.value, ec);
       }
    }
@@ -289,7 +355,7 @@ struct list_impl {
            return;
         }
 
-        result.push_back({});
+        result.emplace_back();
         boost_redis_from_bulk(result.back(), nd.value, ec);
       }
    }
@@ -297,9 +363,18 @@ struct list_impl {
 
 //---------------------------------------------------
 
-template <class T>
+// Defined in describe.hpp.
+template <class Result>
+class struct_impl;
+
+// The second parameter allows specializations for families of types
+// e.g. structs described with Boost.Describe, see describe.hpp.
+template <class T, class = void>
 struct impl_map { using type = simple_impl<T>; };
 
+template <class T>
+struct impl_map<T, std::enable_if_t<is_described_struct<T>::value>> { using type = struct_impl<T>; };
+
 template <class Key, class Compare, class Allocator>
 struct impl_map<std::set<Key, Compare, Allocator>> { using type = set_impl<std::set<Key, Compare, Allocator>>; };
 
@@ -386,6 +461,20 @@ public:
       BOOST_ASSERT(result_);
       impl_(result_->value(), nd, ec);
    }
+
+   // Returns the string where a top-level blob string can be read
+   // into directly or nullptr if not supported.
+   auto get_bulk_destination() -> std::string*
+   {
+      BOOST_ASSERT_MSG(!!result_, "Unexpected null pointer");
+
+      if constexpr (std::is_same_v<Result, std::string>) {
+         if (!result_->has_error())
+            return &result_->value();
+      }
+
+      return nullptr;
+   }
 };
 
 template <class T>
@@ -437,6 +526,23 @@ public:
 
       impl_(result_->value().value(), nd, ec);
    }
+
+   // See wrapper<result<Result>>.
+   auto get_bulk_destination() -> std::string*
+   {
+      BOOST_ASSERT_MSG(!!result_, "Unexpected null pointer");
+
+      if constexpr (std::is_same_v<T, std::string>) {
+         if (!result_->has_error()) {
+            if (!result_->value().has_value())
+               result_->value() = T{};
+
+            return &result_->value().value();
+         }
+      }
+
+      return nullptr;
+   }
 };
 
 } // boost::redis::adapter::detail
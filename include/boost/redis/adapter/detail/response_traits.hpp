@@ -14,13 +14,26 @@
 #include <boost/system.hpp>
 
 #include <tuple>
+#include <type_traits>
 #include <limits>
+#include <memory>
+#include <string>
 #include <string_view>
 #include <variant>
+#include <vector>
 
 namespace boost::redis::adapter::detail
 {
 
+// Detects adapters that support reading blob strings directly into
+// the response, see wrapper<result<T>>::get_bulk_destination.
+template <class T, class = void>
+struct has_bulk_destination : std::false_type {};
+
+template <class T>
+struct has_bulk_destination<T, std::void_t<decltype(std::declval<T&>().get_bulk_destination())>>
+   : std::true_type {};
+
 class ignore_adapter {
 public:
    template <class String>
@@ -37,6 +50,9 @@ public:
    [[nodiscard]]
    auto get_supported_response_size() const noexcept
       { return static_cast<std::size_t>(-1);}
+
+   auto get_bulk_destination(std::size_t) noexcept -> std::string*
+      { return nullptr; }
 };
 
 template <class Response>
@@ -67,6 +83,18 @@ public:
       BOOST_ASSERT(i < adapters_.size());
       visit([&](auto& arg){arg(nd, ec);}, adapters_.at(i));
    }
+
+   auto get_bulk_destination(std::size_t i) -> std::string*
+   {
+      using std::visit;
+      BOOST_ASSERT(i < adapters_.size());
+      return visit([](auto& arg) -> std::string* {
+         if constexpr (has_bulk_destination<std::decay_t<decltype(arg)>>::value)
+            return arg.get_bulk_destination();
+         else
+            return nullptr;
+      }, adapters_.at(i));
+   }
 };
 
 template <class Vector>
@@ -90,6 +118,9 @@ public:
    {
       adapter_(nd, ec);
    }
+
+   auto get_bulk_destination(std::size_t) noexcept -> std::string*
+      { return nullptr; }
 };
 
 template <class>
@@ -122,6 +153,24 @@ struct response_traits<result<std::vector<resp3::basic_node<String>, Allocator>>
       { return adapter_type{v}; }
 };
 
+template <>
+struct response_traits<result<resp3::flat_tree>> {
+   using response_type = result<resp3::flat_tree>;
+   using adapter_type = vector_adapter<response_type>;
+
+   static auto adapt(response_type& v) noexcept
+      { return adapter_type{v}; }
+};
+
+template <>
+struct response_traits<result<resp3::node_queue>> {
+   using response_type = result<resp3::node_queue>;
+   using adapter_type = vector_adapter<response_type>;
+
+   static auto adapt(response_type& v) noexcept
+      { return adapter_type{v}; }
+};
+
 template <class ...Ts>
 struct response_traits<response<Ts...>> {
    using response_type = response<Ts...>;
@@ -140,6 +189,16 @@ public:
    void operator()(resp3::basic_node<String> const& nd, system::error_code& ec)
       { return adapter_(0, nd, ec); }
 
+   template <class String, class Allocator>
+   void operator()(std::vector<resp3::basic_node<String>, Allocator> const& nodes, system::error_code& ec)
+   {
+      for (auto const& nd: nodes) {
+         adapter_(0, nd, ec);
+         if (ec)
+            return;
+      }
+   }
+
    [[nodiscard]]
    auto get_supported_response_size() const noexcept
       { return adapter_.get_supported_response_size();}
@@ -154,6 +213,95 @@ auto make_adapter_wrapper(Adapter adapter)
    return wrapper{adapter};
 }
 
+/* Passes all nodes of a message to the adapter in a single call, see
+ * the batch overload of resp3::parse. When type erased this results
+ * in one indirect call per message instead of one per node.
+ */
+template <class Adapter>
+class batch_adapter {
+public:
+   explicit batch_adapter(Adapter adapter) : adapter_{adapter} {}
+
+   template <class String, class Allocator>
+   void
+   operator()(
+      std::size_t i,
+      std::vector<resp3::basic_node<String>, Allocator> const& nodes,
+      system::error_code& ec)
+   {
+      for (auto const& nd: nodes) {
+         adapter_(i, nd, ec);
+         if (ec)
+            return;
+      }
+   }
+
+   [[nodiscard]]
+   auto get_supported_response_size() const noexcept
+      { return adapter_.get_supported_response_size();}
+
+   auto get_bulk_destination(std::size_t i) -> std::string*
+      { return adapter_.get_bulk_destination(i); }
+
+private:
+   Adapter adapter_;
+};
+
+template <class Adapter>
+auto make_batch_adapter(Adapter adapter)
+{
+   return batch_adapter<Adapter>{adapter};
+}
+
+/* Type-erased batch adapter used by the connection.
+ *
+ * Unlike std::function it also type-erases get_bulk_destination,
+ * which is used to read large blob strings directly into the
+ * response.
+ */
+class any_adapter {
+public:
+   using nodes_type = std::vector<resp3::basic_node<std::string_view>>;
+
+   any_adapter() = default;
+
+   template <class Adapter>
+   explicit any_adapter(Adapter adapter)
+   : impl_{std::make_unique<impl<Adapter>>(std::move(adapter))}
+   { }
+
+   void operator()(std::size_t i, nodes_type const& nodes, system::error_code& ec)
+      { impl_->on_nodes(i, nodes, ec); }
+
+   auto get_bulk_destination(std::size_t i) -> std::string*
+      { return impl_->get_bulk_destination(i); }
+
+   void reset() noexcept
+      { impl_.reset(); }
+
+private:
+   struct base {
+      virtual ~base() = default;
+      virtual void on_nodes(std::size_t i, nodes_type const& nodes, system::error_code& ec) = 0;
+      virtual auto get_bulk_destination(std::size_t i) -> std::string* = 0;
+   };
+
+   template <class Adapter>
+   struct impl : base {
+      explicit impl(Adapter a) : adapter_{std::move(a)} {}
+
+      void on_nodes(std::size_t i, nodes_type const& nodes, system::error_code& ec) override
+         { adapter_(i, nodes, ec); }
+
+      auto get_bulk_destination(std::size_t i) -> std::string* override
+         { return adapter_.get_bulk_destination(i); }
+
+      Adapter adapter_;
+   };
+
+   std::unique_ptr<base> impl_;
+};
+
 } // boost::redis::adapter::detail
 
 #endif // BOOST_REDIS_ADAPTER_DETAIL_RESPONSE_TRAITS_HPP
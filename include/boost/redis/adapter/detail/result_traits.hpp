@@ -62,6 +62,20 @@ struct result_traits<result<std::vector<resp3::basic_node<String>, Allocator>>>
    static auto adapt(response_type& v) noexcept { return adapter_type{&v}; }
 };
 
+template <>
+struct result_traits<result<resp3::flat_tree>> {
+   using response_type = result<resp3::flat_tree>;
+   using adapter_type = adapter::detail::general_flat_aggregate<response_type>;
+   static auto adapt(response_type& v) noexcept { return adapter_type{&v}; }
+};
+
+template <>
+struct result_traits<result<resp3::node_queue>> {
+   using response_type = result<resp3::node_queue>;
+   using adapter_type = adapter::detail::general_queue_aggregate<response_type>;
+   static auto adapt(response_type& v) noexcept { return adapter_type{&v}; }
+};
+
 template <class T>
 using adapter_t = typename result_traits<std::decay_t<T>>::adapter_type;
 
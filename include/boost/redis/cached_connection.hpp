@@ -0,0 +1,252 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_CACHED_CONNECTION_HPP
+#define BOOST_REDIS_CACHED_CONNECTION_HPP
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/client_cache.hpp>
+#include <boost/redis/config.hpp>
+#include <boost/redis/logger.hpp>
+#include <boost/redis/operation.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/response.hpp>
+#include <boost/redis/detail/cluster.hpp>
+#include <boost/redis/detail/raw_replies.hpp>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/post.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis {
+namespace detail
+{
+
+// Returns true if the reply to the command depends only on the
+// value of its first argument, a key, and can therefore be cached
+// until the key is invalidated.
+auto is_cacheable_command(std::string_view cmd) noexcept -> bool;
+
+struct cached_exec_state {
+   std::vector<cluster_command> cmds;
+
+   // The key and cache epoch of each command, if cacheable.
+   std::vector<std::optional<std::string_view>> keys;
+   std::vector<std::size_t> epochs;
+
+   // Set when all replies are served from the cache.
+   bool hit = false;
+   std::vector<client_cache::reply_type> cached;
+
+   raw_replies replies;
+   std::size_t connections = 0;
+};
+
+template <class Conn, class Response>
+struct cached_exec_op {
+   Conn* conn_;
+   request const* req_;
+   Response* resp_;
+   std::unique_ptr<cached_exec_state> st_ = std::make_unique<cached_exec_state>();
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t n = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro)
+      {
+         conn_->lookup(*req_, *st_, ec);
+         if (ec) {
+            self.complete(ec, 0);
+            return;
+         }
+
+         if (st_->hit) {
+            BOOST_ASIO_CORO_YIELD
+            asio::post(std::move(self));
+
+            deliver_replies(st_->cached, *resp_, ec);
+            self.complete(ec, 0);
+            return;
+         }
+
+         BOOST_ASIO_CORO_YIELD
+         conn_->conn_.async_exec(*req_, st_->replies, std::move(self));
+         if (ec) {
+            self.complete(ec, 0);
+            return;
+         }
+
+         conn_->store(*st_);
+         deliver_replies(st_->replies.values, *resp_, ec);
+         self.complete(ec, n);
+      }
+   }
+};
+
+template <class Conn>
+struct cached_run_op {
+   Conn* conn_;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro)
+      {
+         conn_->run_connection();
+
+         for (;;) {
+            BOOST_ASIO_CORO_YIELD
+            conn_->conn_.async_receive(std::move(self));
+            if (ec)
+               break;
+
+            conn_->on_push();
+         }
+
+         self.complete(ec);
+      }
+   }
+};
+
+} // detail
+
+/** @brief A connection with a local cache of read commands.
+ *  @ingroup high-level-api
+ *
+ *  Implements server-assisted client-side caching, see
+ *  https://redis.io/docs/manual/client-side-caching/. The
+ *  connection enables `CLIENT TRACKING` during the handshake and
+ *  replies to cacheable commands, e.g. `GET`, `HGET` or `SMEMBERS`,
+ *  are stored in a `boost::redis::client_cache`. A request whose
+ *  commands are all cacheable and found in the cache completes
+ *  without contacting the server. Entries are removed when the
+ *  server sends an invalidation message for their key.
+ *
+ *  The cache is cleared whenever a new connection is established,
+ *  since invalidation messages might have been lost. Replies read
+ *  while disconnected might therefore be stale.
+ *
+ *  Server pushes are consumed by the invalidation loop, use a
+ *  separate connection for Pub/Sub.
+ */
+class cached_connection {
+public:
+   /// Executor type.
+   using executor_type = asio::any_io_executor;
+
+   /** @brief Constructor
+    *
+    *  @param ex Executor on which the connection runs.
+    *  @param cache_capacity Maximum number of cached replies.
+    *  @param method SSL method.
+    *  @param max_read_size See `boost::redis::basic_connection`.
+    */
+   explicit
+   cached_connection(
+      executor_type ex,
+      std::size_t cache_capacity = 10000,
+      asio::ssl::context::method method = asio::ssl::context::tls_client,
+      std::size_t max_read_size = (std::numeric_limits<std::size_t>::max)());
+
+   /// Returns the underlying executor.
+   executor_type get_executor() noexcept
+      { return conn_.get_executor(); }
+
+   /// Returns the underlying connection.
+   auto next_layer() noexcept -> connection&
+      { return conn_; }
+
+   /// Returns the cache.
+   auto get_cache() noexcept -> client_cache&
+      { return cache_; }
+
+   /** @brief Starts the connection.
+    *
+    *  Calls `boost::redis::basic_connection::async_run` with
+    *  `config::tracking` set to `client_tracking::on` unless another
+    *  mode has been set, and processes invalidation messages until
+    *  the connection is cancelled.
+    *
+    *  @param cfg Configuration parameters.
+    *  @param l Logger object, converted to `logger`, see `boost::redis::basic_logger`.
+    *  @param token Completion token with signature `void(system::error_code)`.
+    */
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto
+   async_run(
+      config const& cfg = {},
+      logger l = logger{},
+      CompletionToken token = CompletionToken{})
+   {
+      start_run(cfg, l);
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code)
+         >(detail::cached_run_op<cached_connection>{this}, token, conn_);
+   }
+
+   /** @brief Executes a request.
+    *
+    *  See `boost::redis::basic_connection::async_exec`. Completes
+    *  with the cached replies if all commands in the request are
+    *  cacheable and cached, in which case the number of bytes read
+    *  passed to the completion is zero.
+    */
+   template <
+      class Response = ignore_t,
+      class CompletionToken = asio::default_completion_token_t<executor_type>
+   >
+   auto
+   async_exec(
+      request const& req,
+      Response& resp = ignore,
+      CompletionToken token = CompletionToken{})
+   {
+      using namespace boost::redis::adapter;
+      BOOST_ASSERT_MSG(req.get_expected_responses() <= boost_redis_adapt(resp).get_supported_response_size(), "Request and response have incompatible sizes.");
+
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(detail::cached_exec_op<cached_connection, Response>{this, &req, &resp}, token, conn_);
+   }
+
+   /// Calls `boost::redis::basic_connection::cancel`.
+   void cancel(operation op = operation::all)
+      { conn_.cancel(op); }
+
+private:
+   template <class, class> friend struct detail::cached_exec_op;
+   template <class> friend struct detail::cached_run_op;
+
+   void start_run(config const& cfg, logger l);
+   void run_connection();
+   void on_push();
+   void check_connections();
+   auto is_tracked(std::string_view key) const noexcept -> bool;
+   void lookup(request const& req, detail::cached_exec_state& st, system::error_code& ec);
+   void store(detail::cached_exec_state& st);
+
+   connection conn_;
+   client_cache cache_;
+   config cfg_;
+   logger logger_;
+   generic_response push_resp_;
+   std::size_t connections_ = 0;
+};
+
+} // boost::redis
+
+#endif // BOOST_REDIS_CACHED_CONNECTION_HPP
@@ -0,0 +1,133 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_CLIENT_CACHE_HPP
+#define BOOST_REDIS_CLIENT_CACHE_HPP
+
+#include <boost/redis/resp3/node.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace boost::redis {
+
+/** @brief A local cache of replies to read commands.
+ *  @ingroup high-level-api
+ *
+ *  Maps commands, e.g. `GET key` or `HGET key field`, to their
+ *  replies and evicts the least recently used entries when full.
+ *  Entries are grouped by key so that all entries of a key can be
+ *  removed when the server invalidates it, see
+ *  `boost::redis::cached_connection`.
+ *
+ *  The entries are spread over shards by the hash of their key,
+ *  each protected by its own mutex, so that the cache can be shared
+ *  by connections running on different threads.
+ */
+class client_cache {
+public:
+   /// The reply type.
+   using reply_type = std::vector<resp3::node>;
+
+   /** @brief Constructor
+    *
+    *  @param capacity Maximum number of entries.
+    *  @param shards Number of shards.
+    */
+   explicit client_cache(std::size_t capacity = 10000, std::size_t shards = 16);
+
+   /** @brief Looks up the reply to a command.
+    *
+    *  @param key The key read by the command.
+    *  @param cmd The serialized command.
+    *  @param reply Receives a copy of the reply on a hit.
+    *  @returns True on a hit.
+    */
+   bool get(std::string_view key, std::string_view cmd, reply_type& reply);
+
+   /** @brief Returns the invalidation epoch of a key.
+    *
+    *  The epoch changes whenever the key, or another key that
+    *  shares its shard, is invalidated. Read it before sending a
+    *  command to the server and pass it to `put` along with the
+    *  reply.
+    */
+   auto get_epoch(std::string_view key) -> std::size_t;
+
+   /** @brief Stores the reply to a command.
+    *
+    *  The reply is not stored if the key might have been invalidated
+    *  since the epoch was read, since it could then be stale.
+    *
+    *  @param key The key read by the command.
+    *  @param cmd The serialized command.
+    *  @param reply The reply.
+    *  @param epoch The value returned by `get_epoch` before the command was sent.
+    *  @returns True if the reply has been stored.
+    */
+   bool put(std::string_view key, std::string_view cmd, reply_type reply, std::size_t epoch);
+
+   /// Removes all entries of a key.
+   void invalidate(std::string_view key);
+
+   /// Removes all entries.
+   void clear();
+
+   /// Returns the number of entries.
+   auto size() const -> std::size_t;
+
+   /// Returns the number of lookups that found an entry.
+   auto get_hits() const noexcept -> std::size_t
+      { return hits_.load(std::memory_order_relaxed); }
+
+   /// Returns the number of lookups that did not find an entry.
+   auto get_misses() const noexcept -> std::size_t
+      { return misses_.load(std::memory_order_relaxed); }
+
+   /// Returns the number of calls to `invalidate` and `clear`.
+   auto get_invalidations() const noexcept -> std::size_t
+      { return invalidations_.load(std::memory_order_relaxed); }
+
+private:
+   struct entry {
+      std::string key;
+      std::string cmd;
+      reply_type reply;
+   };
+
+   using list_type = std::list<entry>;
+
+   // The commands in by_cmd are views into the entries, whose
+   // addresses are stable. The most recently used entry is at the
+   // front of the list.
+   struct shard {
+      std::mutex mutex;
+      list_type lru;
+      std::unordered_map<std::string_view, list_type::iterator> by_cmd;
+      std::unordered_map<std::string, std::vector<list_type::iterator>> by_key;
+      std::size_t epoch = 0;
+   };
+
+   auto get_shard(std::string_view key) -> shard&;
+   static void erase(shard& s, list_type::iterator it);
+
+   std::vector<std::unique_ptr<shard>> shards_;
+   std::size_t shard_capacity_;
+   std::atomic<std::size_t> hits_{0};
+   std::atomic<std::size_t> misses_{0};
+   std::atomic<std::size_t> invalidations_{0};
+};
+
+} // boost::redis
+
+#endif // BOOST_REDIS_CLIENT_CACHE_HPP
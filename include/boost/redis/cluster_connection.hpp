@@ -0,0 +1,319 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_CLUSTER_CONNECTION_HPP
+#define BOOST_REDIS_CLUSTER_CONNECTION_HPP
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/config.hpp>
+#include <boost/redis/logger.hpp>
+#include <boost/redis/operation.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/response.hpp>
+#include <boost/redis/detail/cluster.hpp>
+#include <boost/redis/adapter/adapt.hpp>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/any_completion_handler.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace boost::redis {
+
+class cluster_connection;
+
+namespace detail
+{
+
+// Waits for the subrequests of a round to complete.
+template <class Self>
+struct cluster_exec_join {
+   Self self;
+   std::size_t pending;
+   system::error_code ec;
+   std::size_t size = 0;
+
+   void on_done(system::error_code const& e, std::size_t n)
+   {
+      if (e && !ec)
+         ec = e;
+
+      size += n;
+      if (--pending == 0)
+         self(ec, size);
+   }
+};
+
+template <class Conn, class Response>
+struct cluster_exec_op {
+   Conn* conn_;
+   request const* req_;
+   Response* resp_;
+   std::unique_ptr<cluster_exec_state> st_ = std::make_unique<cluster_exec_state>();
+   std::size_t round_ = 0;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t n = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro)
+      {
+         conn_->init_exec(*req_, *st_, ec);
+         if (ec) {
+            self.complete(ec, 0);
+            return;
+         }
+
+         for (round_ = 0; !st_->pending.empty(); ++round_) {
+            conn_->make_subrequests(*req_, *st_);
+
+            BOOST_ASIO_CORO_YIELD
+            {
+               // The op is moved into the join, use only locals from
+               // here on.
+               auto* conn = conn_;
+               auto* st = st_.get();
+               auto join = std::make_shared<cluster_exec_join<Self>>(cluster_exec_join<Self>{std::move(self), std::size(st->subs), {}, 0});
+               for (auto& sub: st->subs) {
+                  conn->get_node_connection(sub.node).async_exec(sub.req, sub.replies, [join](system::error_code ec, std::size_t n) {
+                     join->on_done(ec, n);
+                  });
+               }
+            }
+
+            if (ec) {
+               self.complete(ec, 0);
+               return;
+            }
+
+            st_->size += n;
+            conn_->on_subrequests(*st_, round_ + 1 < Conn::max_redirections);
+         }
+
+         // Passes the replies to the response in the original order.
+         deliver_replies(st_->replies, *resp_, ec);
+         if (ec) {
+            self.complete(ec, 0);
+            return;
+         }
+
+         self.complete({}, st_->size);
+      }
+   }
+};
+
+template <class Conn>
+struct cluster_run_op {
+   Conn* conn_;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro)
+      {
+         conn_->run_node(0);
+
+         while (conn_->running_) {
+            conn_->prepare_refresh();
+            BOOST_ASIO_CORO_YIELD
+            conn_->get_node_connection(conn_->refresh_node_).async_exec(conn_->slots_req_, conn_->slots_resp_, std::move(self));
+
+            if (!conn_->running_)
+               break;
+
+            if (ec && conn_->cfg_.reconnect_wait_interval == std::chrono::seconds::zero()) {
+               // The node connections don't outlive the run.
+               conn_->cancel(operation::run);
+               self.complete(ec);
+               return;
+            }
+
+            // On success the map is refreshed again only after a
+            // redirection, otherwise it is retried after the
+            // reconnection interval, possibly on another node.
+            conn_->on_cluster_slots(ec);
+
+            BOOST_ASIO_CORO_YIELD
+            conn_->timer_.async_wait(std::move(self));
+         }
+
+         self.complete(asio::error::operation_aborted);
+      }
+   }
+};
+
+} // detail
+
+/** @brief A connection to a Redis Cluster.
+ *  @ingroup high-level-api
+ *
+ *  Keeps one `boost::redis::connection` to each primary in the
+ *  cluster and routes each command to the node that serves the hash
+ *  slot of its key. The map of slots to nodes is fetched with
+ *  `CLUSTER SLOTS` from the node passed in `config::addr` when
+ *  `async_run` is called.
+ *
+ *  A request can contain commands with keys in different slots. The
+ *  request is split in one request per node, they are executed
+ *  concurrently and their responses are merged back into the
+ *  response passed to `async_exec` in the original order. Commands
+ *  between `MULTI` and `EXEC` are sent together to the node of the
+ *  first key in the transaction. Commands without keys e.g. `PING`
+ *  are sent to the node passed in the config.
+ *
+ *  `MOVED` and `ASK` redirections are followed transparently,
+ *  `MOVED` also triggers a refresh of the slot map. When the
+ *  server does not have cluster support enabled all commands are
+ *  sent to the node passed in the config.
+ *
+ *  This class is not thread-safe, like `boost::redis::connection`.
+ */
+class cluster_connection {
+public:
+   /// Executor type.
+   using executor_type = asio::any_io_executor;
+
+   /// Maximum number of redirections followed by a command.
+   static constexpr std::size_t max_redirections = 5;
+
+   /** @brief Constructor
+    *
+    *  @param ex Executor on which the connections run.
+    *  @param method SSL method used by the connections.
+    *  @param max_read_size See `boost::redis::basic_connection`.
+    */
+   explicit
+   cluster_connection(
+      executor_type ex,
+      asio::ssl::context::method method = asio::ssl::context::tls_client,
+      std::size_t max_read_size = (std::numeric_limits<std::size_t>::max)());
+
+   /// Returns the underlying executor.
+   executor_type get_executor() noexcept
+      { return ex_; }
+
+   /// Returns the number of nodes known to the connection.
+   auto get_nodes() const noexcept
+      { return std::size(nodes_); }
+
+   /** @brief Starts the connection to the cluster.
+    *
+    *  Connects to the node in `cfg.addr`, fetches the slot map and
+    *  connects to the primaries. Each connection reconnects and
+    *  checks health on its own, see
+    *  `boost::redis::basic_connection::async_run`.
+    *
+    *  @param cfg Configuration parameters used by all connections.
+    *  @param l Logger object, converted to `logger`, see `boost::redis::basic_logger`.
+    *  @param token Completion token with signature `void(system::error_code)`.
+    */
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto
+   async_run(
+      config const& cfg = {},
+      logger l = logger{},
+      CompletionToken token = CompletionToken{})
+   {
+      start_run(cfg, l);
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code)
+         >(detail::cluster_run_op<cluster_connection>{this}, token, timer_);
+   }
+
+   /** @brief Executes a request on the cluster.
+    *
+    *  See `boost::redis::basic_connection::async_exec`. Commands are
+    *  routed by their keys and the responses are merged in the
+    *  original order.
+    *
+    *  @param req Request.
+    *  @param resp Response.
+    *  @param token Completion token with signature `void(system::error_code, std::size_t)`.
+    */
+   template <
+      class Response = ignore_t,
+      class CompletionToken = asio::default_completion_token_t<executor_type>
+   >
+   auto
+   async_exec(
+      request const& req,
+      Response& resp = ignore,
+      CompletionToken token = CompletionToken{})
+   {
+      using namespace boost::redis::adapter;
+      BOOST_ASSERT_MSG(req.get_expected_responses() <= boost_redis_adapt(resp).get_supported_response_size(), "Request and response have incompatible sizes.");
+
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(detail::cluster_exec_op<cluster_connection, Response>{this, &req, &resp}, token, timer_);
+   }
+
+   /** @brief Cancel operations.
+    *
+    *  Calls `boost::redis::basic_connection::cancel` on the
+    *  connection to each node. `operation::run` and
+    *  `operation::all` also stop the refreshes of the slot map.
+    */
+   void cancel(operation op = operation::all);
+
+private:
+   template <class, class> friend struct detail::cluster_exec_op;
+   template <class> friend struct detail::cluster_run_op;
+
+   struct node {
+      node(executor_type ex, asio::ssl::context::method method, std::size_t max_read_size)
+      : conn{ex, method, max_read_size}
+      { }
+
+      connection conn;
+   };
+
+   auto get_node_connection(std::size_t i) -> connection&
+      { return nodes_[i]->conn; }
+
+   void start_run(config const& cfg, logger l);
+   void run_node(std::size_t i);
+   void add_nodes();
+   void prepare_refresh();
+   void on_cluster_slots(system::error_code ec);
+   void request_refresh();
+
+   void init_exec(request const& req, detail::cluster_exec_state& st, system::error_code& ec);
+   void make_subrequests(request const& req, detail::cluster_exec_state& st);
+   void on_subrequests(detail::cluster_exec_state& st, bool follow_redirections);
+
+   executor_type ex_;
+   asio::ssl::context::method method_;
+   std::size_t max_read_size_;
+
+   // A connection for each node in the router, at the same position.
+   std::vector<std::unique_ptr<node>> nodes_;
+   detail::cluster_router router_;
+
+   config cfg_;
+   logger logger_;
+   bool running_ = false;
+   asio::steady_timer timer_;
+   request slots_req_;
+   generic_response slots_resp_;
+   std::size_t refresh_node_ = 0;
+   bool refresh_pending_ = false;
+};
+
+} // boost::redis
+
+#endif // BOOST_REDIS_CLUSTER_CONNECTION_HPP
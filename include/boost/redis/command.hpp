@@ -0,0 +1,112 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_COMMAND_HPP
+#define BOOST_REDIS_COMMAND_HPP
+
+#include <cstddef>
+#include <string_view>
+
+namespace boost::redis {
+namespace detail
+{
+
+// Writes the decimal representation of n at out[pos] and returns the
+// position past it.
+constexpr auto write_number(char* out, std::size_t pos, std::size_t n) noexcept -> std::size_t
+{
+   char digits[20] = {};
+   std::size_t size = 0;
+   do {
+      digits[size++] = static_cast<char>('0' + n % 10);
+      n /= 10;
+   } while (n != 0);
+
+   while (size != 0)
+      out[pos++] = digits[--size];
+
+   return pos;
+}
+
+constexpr auto write_string(char* out, std::size_t pos, char const* str, std::size_t size) noexcept -> std::size_t
+{
+   for (std::size_t i = 0; i < size; ++i)
+      out[pos++] = str[i];
+
+   return pos;
+}
+
+} // detail
+
+/** @brief A command whose name and number of arguments are known at compile time.
+ *  @ingroup high-level-api
+ *
+ *  The array header and the command name are serialized when the
+ *  object is constructed, which happens at compile time when it is
+ *  declared `constexpr`, so that `request::push` only has to copy
+ *  them before serializing the arguments. Use `make_command` to
+ *  create objects of this type, for example
+ *
+ *  @code
+ *  constexpr auto set_cmd = make_command<2>("SET");
+ *
+ *  request req;
+ *  req.push(set_cmd, "key", 42);
+ *  @endcode
+ *
+ *  @tparam N Size of the command name including the null terminator.
+ *  @tparam Args Number of arguments.
+ */
+template <std::size_t N, std::size_t Args>
+class static_command {
+public:
+   /// The number of arguments.
+   static constexpr std::size_t args = Args;
+
+   /// Constructor
+   constexpr explicit static_command(char const (&name)[N]) noexcept
+   {
+      // *<1 + Args>\r\n$<N - 1>\r\n<name>\r\n
+      size_ = detail::write_string(prefix_, size_, "*", 1);
+      size_ = detail::write_number(prefix_, size_, 1 + Args);
+      size_ = detail::write_string(prefix_, size_, "\r\n$", 3);
+      size_ = detail::write_number(prefix_, size_, N - 1);
+      size_ = detail::write_string(prefix_, size_, "\r\n", 2);
+      size_ = detail::write_string(prefix_, size_, name, N - 1);
+      size_ = detail::write_string(prefix_, size_, "\r\n", 2);
+      name_ = size_ - N - 1;
+   }
+
+   /// Returns the command name.
+   constexpr auto get_name() const noexcept -> std::string_view
+      { return {prefix_ + name_, N - 1}; }
+
+   /// Returns the serialized array header and command name.
+   constexpr auto get_prefix() const noexcept -> std::string_view
+      { return {prefix_, size_}; }
+
+private:
+   // The headers have at most 20 digits each.
+   char prefix_[N + 48] = {};
+   std::size_t size_ = 0;
+   std::size_t name_ = 0;
+};
+
+/** @brief Creates a `static_command`.
+ *  @ingroup high-level-api
+ *
+ *  @tparam Args Number of arguments of the command.
+ *  @param name The command name.
+ */
+template <std::size_t Args, std::size_t N>
+constexpr auto make_command(char const (&name)[N]) noexcept
+{
+   return static_command<N, Args>{name};
+}
+
+} // boost::redis
+
+#endif // BOOST_REDIS_COMMAND_HPP
@@ -10,6 +10,7 @@
 #include <string>
 #include <chrono>
 #include <optional>
+#include <vector>
 
 namespace boost::redis
 {
@@ -24,6 +25,54 @@ struct address {
    std::string port = "6379";
 };
 
+/** @brief Modes of server-assisted client-side caching
+ *  @ingroup high-level-api
+ *
+ *  See [CLIENT TRACKING](https://redis.io/commands/client-tracking/).
+ */
+enum class client_tracking {
+   /// Tracking is disabled.
+   off,
+
+   /// The server sends invalidation messages for the keys read by the client.
+   on,
+
+   /// The server sends invalidation messages for all keys that match `config::tracking_prefixes`.
+   bcast,
+};
+
+/** @brief When the health checker sends `PING`
+ *  @ingroup high-level-api
+ *
+ *  See `config::health_check_interval`.
+ */
+enum class health_check_policy {
+   /// Sends a `PING` every interval, the check fails if no reply arrives within two intervals.
+   always,
+
+   /// Sends a `PING` only after an interval without other responses or pushes, the check fails if nothing arrives within two intervals.
+   idle,
+};
+
+/** @brief What to do with a push that arrives when the receive channel is full
+ *  @ingroup high-level-api
+ *
+ *  See `config::push_channel_capacity`.
+ */
+enum class push_policy {
+   /// Stops reading from the socket until a push is received, which also delays responses.
+   block,
+
+   /// Removes the oldest push from the response passed to `set_receive_response`, see below.
+   drop_oldest,
+
+   /// Discards the push that has just arrived.
+   drop_newest,
+
+   /// Queues the push while the pushes beyond capacity use at most `config::push_spill_limit` bytes, then blocks.
+   spill,
+};
+
 /** @brief Configure parameters used by the connection classes
  *  @ingroup high-level-api
  */
@@ -52,6 +101,16 @@ struct config {
    /// Database that will be passed to the [SELECT](https://redis.io/commands/hello/) command.
    std::optional<int> database_index = 0;
 
+   /** @brief Enables `CLIENT TRACKING` after `HELLO`.
+    *
+    *  Invalidation messages are received as server pushes, see
+    *  `boost::redis::cached_connection`.
+    */
+   client_tracking tracking = client_tracking::off;
+
+   /// Key prefixes passed to `CLIENT TRACKING` in `client_tracking::bcast` mode.
+   std::vector<std::string> tracking_prefixes;
+
    /// Message used by the health-checker in `boost::redis::connection::async_run`.
    std::string health_check_id = "Boost.Redis";
 
@@ -73,11 +132,83 @@ struct config {
     */
    std::chrono::steady_clock::duration health_check_interval = std::chrono::seconds{2};
 
+   /** @brief When health checks send `PING`.
+    *
+    *  With `health_check_policy::idle` any response or push counts
+    *  as proof that the server is alive, so busy connections don't
+    *  send `PING` at all. The round trip time of the `PING`s that
+    *  are sent is reported in `usage`.
+    */
+   health_check_policy health_check = health_check_policy::always;
+
    /** @brief Time waited before trying a reconnection.
     *  
     *  To disable reconnection pass zero as duration.
     */
    std::chrono::steady_clock::duration reconnect_wait_interval = std::chrono::seconds{1};
+
+   /** @brief Payloads of at least this size are written without copying.
+    *
+    *  Payloads of requests smaller than this value are copied
+    *  into a single buffer before writing, larger ones are written
+    *  directly from the request together with the other pending
+    *  requests with a single gather-write. To always copy pass
+    *  `(std::numeric_limits<std::size_t>::max)()`.
+    */
+   std::size_t write_copy_threshold = 16 * 1024;
+
+   /// Capacity reserved for the read buffer when the connection is established.
+   std::size_t read_buffer_initial_capacity = 4096;
+
+   /** @brief Number of bytes the read buffer grows on each read.
+    *
+    *  The read buffer grows by at least this amount before each
+    *  read, more if a larger bulk string is being read.
+    */
+   std::size_t read_buffer_append_size = 4096;
+
+   /** @brief Read buffer capacity above which its memory is released.
+    *
+    *  When the read buffer becomes empty and its capacity exceeds
+    *  this value, e.g. after reading a large response, its memory is
+    *  released and `read_buffer_initial_capacity` is reserved
+    *  again. To never release memory pass
+    *  `(std::numeric_limits<std::size_t>::max)()`.
+    */
+   std::size_t read_buffer_shrink_threshold = 1024 * 1024;
+
+   /** @brief Blob strings of at least this size are read directly into the response.
+    *
+    *  Applies to top-level blob strings read into a `std::string`
+    *  or `std::optional<std::string>` element of a `response` e.g.
+    *  the response to `GET`. The part of the blob not yet received
+    *  is read from the socket straight into the response instead of
+    *  going through the read buffer, saving one copy. To disable pass
+    *  `(std::numeric_limits<std::size_t>::max)()`.
+    */
+   std::size_t direct_read_threshold = 1024 * 1024;
+
+   /// Maximum number of pushes waiting to be received before `push_overflow` applies.
+   std::size_t push_channel_capacity = 256;
+
+   /** @brief What to do with pushes that arrive when the channel is full.
+    *
+    *  With `push_policy::block` a slow push consumer delays the
+    *  responses to all requests on the connection, the other
+    *  policies keep reading at the cost of dropping or buffering
+    *  pushes.
+    *
+    *  `push_policy::drop_oldest` is only supported when the receive
+    *  response is a `generic_response` or `generic_queue_response`,
+    *  for other responses it behaves like `push_policy::drop_newest`.
+    *  Received pushes must be removed from the response with
+    *  `consume_one` or `clear` before suspending again, see the
+    *  precondition of `basic_connection::async_receive`.
+    */
+   push_policy push_overflow = push_policy::block;
+
+   /// Maximum number of bytes in pushes beyond capacity with `push_policy::spill`.
+   std::size_t push_spill_limit = 16 * 1024 * 1024;
 };
 
 } // boost::redis
@@ -19,6 +19,7 @@
 #include <chrono>
 #include <memory>
 #include <limits>
+#include <type_traits>
 
 namespace boost::redis {
 namespace detail
@@ -66,9 +67,32 @@ struct reconnection_op {
  *  documentation of each individual function.
  *
  *  @tparam Socket The socket type e.g. asio::ip::tcp::socket.
+ *  @tparam Metrics The metrics policy, `no_metrics` or
+ *  `latency_metrics`, see `get_metrics`.
+ *  @tparam Observer Receives the events of each request, see below.
  *
+ *  The observer is a class with an `on_event` overload for each of
+ *  `enqueue_event`, `stage_event`, `write_event`, `first_byte_event`,
+ *  `parse_event` and `completion_event`, which are called in this
+ *  order for each request on the connection executor, including the
+ *  `HELLO` and `PING` the connection sends itself. For example
+ *
+ *  @code
+ *  struct tracer {
+ *     template <class Event>
+ *     void on_event(Event const& ev) { ... }
+ *  };
+ *
+ *  basic_connection<asio::any_io_executor, no_metrics, tracer> conn{ex};
+ *  @endcode
+ *
+ *  Events carry the request id and a timestamp, so they can be
+ *  turned into e.g. OpenTelemetry spans without formatting. The
+ *  request may fail or be cancelled at any point, in which case the
+ *  `completion_event` follows directly. The default `no_observer`
+ *  adds no overhead.
  */
-template <class Executor>
+template <class Executor, class Metrics = no_metrics, class Observer = no_observer>
 class basic_connection {
 public:
    /// Executor type.
@@ -83,7 +107,7 @@ public:
    struct rebind_executor
    {
       /// The connection type when rebound to the specified executor.
-      using other = basic_connection<Executor1>;
+      using other = basic_connection<Executor1, Metrics, Observer>;
    };
 
    /// Contructs from an executor.
@@ -151,7 +175,7 @@ public:
       Logger l = Logger{},
       CompletionToken token = CompletionToken{})
    {
-      using this_type = basic_connection<executor_type>;
+      using this_type = basic_connection<executor_type, Metrics, Observer>;
 
       cfg_ = cfg;
       l.set_prefix(cfg_.log_prefix);
@@ -171,6 +195,12 @@ public:
     *  To cancel an ongoing receive operation apps should call
     *  `connection::cancel(operation::receive)`.
     *
+    *  Precondition with `push_policy::drop_oldest`: the push that
+    *  completed the previous receive has been removed from the
+    *  receive response e.g. with `consume_one`. The connection drops
+    *  the oldest push in the response, which otherwise is the one
+    *  the app is still reading.
+    *
     *  @param token Completion token.
     *
     *  For an example see cpp20_subscriber.cpp. The completion token must
@@ -193,7 +223,8 @@ public:
     *  Receives a server push synchronously by calling `try_receive` on
     *  the underlying channel. If the operation fails because
     *  `try_receive` returns `false`, `ec` will be set to
-    *  `boost::redis::error::sync_receive_push_failed`.
+    *  `boost::redis::error::sync_receive_push_failed`. The same
+    *  precondition as in `async_receive` applies.
     *
     *  @param ec Contains the error if any occurred.
     *
@@ -311,6 +342,23 @@ public:
    usage get_usage() const noexcept
       { return impl_.get_usage(); }
 
+   /** @brief Returns the connection metrics.
+    *
+    *  Call `snapshot` on the returned object to read them, this is
+    *  safe from any thread. With the default `no_metrics` policy
+    *  nothing is recorded.
+    */
+   auto get_metrics() const noexcept -> Metrics const&
+      { return impl_.get_metrics(); }
+
+   /// Returns the observer.
+   auto get_observer() noexcept -> Observer&
+      { return impl_.get_observer(); }
+
+   /// Returns the observer.
+   auto get_observer() const noexcept -> Observer const&
+      { return impl_.get_observer(); }
+
 private:
    using timer_type =
       asio::basic_waitable_timer<
@@ -321,7 +369,7 @@ private:
    template <class, class> friend struct detail::reconnection_op;
 
    config cfg_;
-   detail::connection_base<executor_type> impl_;
+   detail::connection_base<executor_type, Metrics, Observer> impl_;
    timer_type timer_;
 };
 
@@ -357,16 +405,26 @@ public:
    executor_type get_executor() noexcept
       { return impl_.get_executor(); }
 
-   /// Calls `boost::redis::basic_connection::async_run`.
-   template <class CompletionToken>
-   auto async_run(config const& cfg, logger l, CompletionToken token)
+   /** @brief Calls `boost::redis::basic_connection::async_run`.
+    *
+    *  With the default `logger` the operation is type-erased and
+    *  compiled once. Any other logger type, e.g. a `basic_logger`, is
+    *  forwarded as is to `basic_connection::async_run` so its calls
+    *  can be removed at compile time.
+    */
+   template <class Logger = logger, class CompletionToken>
+   auto async_run(config const& cfg, Logger l, CompletionToken token)
    {
-      return asio::async_initiate<
-         CompletionToken, void(boost::system::error_code)>(
-            [](auto handler, connection* self, config const* cfg, logger l)
-            {
-               self->async_run_impl(*cfg, l, std::move(handler));
-            }, token, this, &cfg, l);
+      if constexpr (std::is_same_v<Logger, logger>) {
+         return asio::async_initiate<
+            CompletionToken, void(boost::system::error_code)>(
+               [](auto handler, connection* self, config const* cfg, logger l)
+               {
+                  self->async_run_impl(*cfg, l, std::move(handler));
+               }, token, this, &cfg, l);
+      } else {
+         return impl_.async_run(cfg, std::move(l), std::move(token));
+      }
    }
 
    /// Calls `boost::redis::basic_connection::async_receive`.
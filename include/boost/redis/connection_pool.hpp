@@ -0,0 +1,245 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_CONNECTION_POOL_HPP
+#define BOOST_REDIS_CONNECTION_POOL_HPP
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/config.hpp>
+#include <boost/redis/logger.hpp>
+#include <boost/redis/operation.hpp>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/any_completion_handler.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/compose.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace boost::redis {
+namespace detail
+{
+
+// A connection in the pool and the number of requests it has not
+// completed yet.
+struct pool_member {
+   pool_member(
+      asio::any_io_executor ex,
+      asio::ssl::context::method method,
+      std::size_t max_read_size)
+   : conn{ex, method, max_read_size}
+   { }
+
+   connection conn;
+   std::atomic<std::size_t> outstanding{0};
+};
+
+// Counts a request as outstanding on a connection for as long as it
+// lives, so that operations destroyed without completing are not
+// counted forever.
+class pool_outstanding_guard {
+public:
+   explicit pool_outstanding_guard(pool_member* member) noexcept
+   : member_{member}
+   { member_->outstanding.fetch_add(1, std::memory_order_relaxed); }
+
+   pool_outstanding_guard(pool_outstanding_guard&& other) noexcept
+   : member_{std::exchange(other.member_, nullptr)}
+   { }
+
+   pool_outstanding_guard(pool_outstanding_guard const&) = delete;
+   auto operator=(pool_outstanding_guard const&) -> pool_outstanding_guard& = delete;
+   auto operator=(pool_outstanding_guard&&) -> pool_outstanding_guard& = delete;
+
+   ~pool_outstanding_guard() { reset(); }
+
+   void reset() noexcept
+   {
+      if (member_ != nullptr)
+         std::exchange(member_, nullptr)->outstanding.fetch_sub(1, std::memory_order_relaxed);
+   }
+
+private:
+   pool_member* member_;
+};
+
+template <class Response>
+struct pool_exec_op {
+   pool_member* member_;
+   pool_outstanding_guard guard_;
+   request const* req_;
+   Response* resp_;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t n = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro)
+      {
+         // Connections are not thread-safe, the request must be
+         // queued from the connection executor.
+         BOOST_ASIO_CORO_YIELD
+         asio::dispatch(member_->conn.get_executor(), std::move(self));
+
+         BOOST_ASIO_CORO_YIELD
+         member_->conn.async_exec(*req_, *resp_, std::move(self));
+
+         guard_.reset();
+         self.complete(ec, n);
+      }
+   }
+};
+
+} // detail
+
+/** @brief A pool of connections spread over the threads of an executor.
+ *  @ingroup high-level-api
+ *
+ *  Each connection in the pool runs on its own strand of the
+ *  executor passed on construction, e.g. the executor of an
+ *  `asio::thread_pool`, so that requests are processed in parallel
+ *  over multiple connections. The public member functions can be
+ *  called from any thread.
+ *
+ *  Requests are sent over the connection with the least number of
+ *  outstanding requests unless a key is provided, in which case all
+ *  requests with the same key are sent over the same connection and
+ *  therefore executed in order. Each connection runs its own
+ *  health-checks and reconnects independently, see
+ *  `boost::redis::basic_connection::async_run`.
+ */
+class connection_pool {
+public:
+   /// Executor type.
+   using executor_type = asio::any_io_executor;
+
+   /** @brief Constructor
+    *
+    *  @param ex Executor on which the connections run. Each
+    *  connection uses its own strand of it.
+    *  @param size Number of connections in the pool.
+    *  @param method SSL method used by the connections.
+    *  @param max_read_size See `boost::redis::basic_connection`.
+    */
+   connection_pool(
+      executor_type ex,
+      std::size_t size,
+      asio::ssl::context::method method = asio::ssl::context::tls_client,
+      std::size_t max_read_size = (std::numeric_limits<std::size_t>::max)());
+
+   /// Returns the executor passed on construction.
+   executor_type get_executor() noexcept
+      { return ex_; }
+
+   /// Returns the number of connections in the pool.
+   auto size() const noexcept
+      { return std::size(members_); }
+
+   /** @brief Returns the connection at position i.
+    *
+    *  Useful to receive server pushes. Notice connections are not
+    *  thread-safe and must be accessed from their executor.
+    */
+   auto at(std::size_t i) -> connection&
+      { return members_.at(i)->conn; }
+
+   /// Returns the number of requests not completed yet on the connection at position i.
+   auto get_outstanding(std::size_t i) const noexcept -> std::size_t
+      { return members_[i]->outstanding.load(std::memory_order_relaxed); }
+
+   /** @brief Runs all connections in the pool.
+    *
+    *  Calls `boost::redis::basic_connection::async_run` on each
+    *  connection and completes when all of them have completed. The
+    *  error passed to the completion is the first non-successful one
+    *  reported by the connections.
+    *
+    *  Only one run operation can be outstanding at a time, calling
+    *  this function again before the previous call has completed
+    *  fails with `asio::error::already_started`.
+    *
+    *  @param cfg Configuration parameters, used by all connections.
+    *  @param l Logger object, converted to `logger`, see `boost::redis::basic_logger`.
+    *  @param token Completion token with signature `void(system::error_code)`.
+    */
+   template <class CompletionToken>
+   auto async_run(config const& cfg, logger l, CompletionToken token)
+   {
+      return asio::async_initiate<
+         CompletionToken, void(system::error_code)>(
+            [](auto handler, connection_pool* self, config const* cfg, logger l)
+            {
+               self->async_run_impl(*cfg, l, std::move(handler));
+            }, token, this, &cfg, l);
+   }
+
+   /** @brief Executes a request on the least loaded connection.
+    *
+    *  See `boost::redis::basic_connection::async_exec`. The request
+    *  and response must be kept alive and untouched until the
+    *  operation completes.
+    */
+   template <class Response, class CompletionToken>
+   auto async_exec(request const& req, Response& resp, CompletionToken token)
+   {
+      return async_exec_on(select_least_loaded(), req, resp, std::move(token));
+   }
+
+   /** @brief Executes a request on the connection assigned to a key.
+    *
+    *  Requests with the same key are always sent over the same
+    *  connection and are therefore executed in the order they have
+    *  been issued.
+    */
+   template <class Response, class CompletionToken>
+   auto async_exec(std::string_view key, request const& req, Response& resp, CompletionToken token)
+   {
+      return async_exec_on(select_by_key(key), req, resp, std::move(token));
+   }
+
+   /// Calls `boost::redis::basic_connection::cancel` on all connections.
+   void cancel(operation op = operation::all);
+
+private:
+   template <class Response, class CompletionToken>
+   auto async_exec_on(std::size_t i, request const& req, Response& resp, CompletionToken token)
+   {
+      auto* member = members_[i].get();
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(detail::pool_exec_op<Response>{member, detail::pool_outstanding_guard{member}, &req, &resp}, token, member->conn);
+   }
+
+   auto select_least_loaded() noexcept -> std::size_t;
+   auto select_by_key(std::string_view key) const noexcept -> std::size_t;
+
+   void
+   async_run_impl(
+      config const& cfg,
+      logger l,
+      asio::any_completion_handler<void(system::error_code)> token);
+
+   executor_type ex_;
+   std::vector<std::unique_ptr<detail::pool_member>> members_;
+   config cfg_;
+   std::atomic<bool> running_{false};
+
+   // Start position of the search for the least loaded connection so
+   // that ties are spread over the connections.
+   std::atomic<std::size_t> next_{0};
+};
+
+} // boost::redis
+
+#endif // BOOST_REDIS_CONNECTION_POOL_HPP
@@ -0,0 +1,191 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_DESCRIBE_HPP
+#define BOOST_REDIS_DESCRIBE_HPP
+
+#include <boost/redis/error.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/resp3/node.hpp>
+#include <boost/redis/resp3/serialization.hpp>
+#include <boost/redis/resp3/type.hpp>
+#include <boost/redis/adapter/detail/adapters.hpp>
+#include <boost/redis/detail/perfect_hash.hpp>
+#include <boost/describe/members.hpp>
+#include <boost/describe/modifiers.hpp>
+#include <boost/mp11/algorithm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/* Support for structs described with Boost.Describe, this header is
+ * not included by boost/redis.hpp since it adds a dependency.
+ *
+ * Structs are read field by field only when is_described_struct is
+ * specialized for them, reading one in a translation unit that does
+ * not include this header fails to compile.
+ */
+
+namespace boost::redis::detail
+{
+
+template <class T>
+using described_fields = describe::describe_members<T, describe::mod_public>;
+
+template <class>
+struct field_names;
+
+template <template <class...> class L, class... D>
+struct field_names<L<D...>> {
+   static constexpr std::array<std::string_view, sizeof...(D)> value{{D::name...}};
+};
+
+// Maps field names to their index in described_fields<T>, built at
+// compile time.
+template <class T>
+struct field_index {
+   static constexpr std::size_t size = mp11::mp_size<described_fields<T>>::value;
+   static constexpr perfect_hash<size> value{field_names<described_fields<T>>::value};
+};
+
+// The arguments of a command built from a struct, see push_struct.
+template <class T>
+struct struct_fields {
+   T const* obj;
+};
+
+} // boost::redis::detail
+
+namespace boost::redis::resp3
+{
+
+template <class T>
+struct add_bulk_impl<redis::detail::struct_fields<T>> {
+   static void add(std::string& payload, redis::detail::struct_fields<T> const& fields)
+   {
+      mp11::mp_for_each<redis::detail::described_fields<T>>([&](auto d)
+      {
+         using namespace boost::redis::resp3;
+         boost_redis_to_bulk(payload, std::string_view{d.name});
+         boost_redis_to_bulk(payload, fields.obj->*d.pointer);
+      });
+   }
+};
+
+template <class T>
+struct bulk_counter<redis::detail::struct_fields<T>> {
+   static constexpr auto size = 2U * mp11::mp_size<redis::detail::described_fields<T>>::value;
+};
+
+} // boost::redis::resp3
+
+namespace boost::redis::adapter::detail
+{
+
+// Reads a map e.g. the reply to HGETALL into a struct, fields are
+// matched by name. Fields that are not in the struct are ignored and
+// members that are not in the map keep their default value.
+template <class Result>
+class struct_impl {
+private:
+   static_assert(describe::has_describe_members<Result>::value, "The struct is not described with Boost.Describe.");
+
+   using fields = redis::detail::described_fields<Result>;
+   using index = redis::detail::field_index<Result>;
+
+   std::size_t field_ = index::size;
+   bool on_key_ = true;
+
+public:
+   void on_value_available(Result&) {}
+
+   template <class String>
+   void operator()(Result& result, resp3::basic_node<String> const& nd, system::error_code& ec)
+   {
+      if (is_aggregate(nd.data_type)) {
+         if (element_multiplicity(nd.data_type) != 2)
+           ec = redis::error::expects_resp3_map;
+         return;
+      }
+
+      BOOST_ASSERT(nd.aggregate_size == 1);
+
+      if (nd.depth < 1) {
+         ec = redis::error::expects_resp3_map;
+         return;
+      }
+
+      if (on_key_) {
+         field_ = index::value.find(std::string_view{nd.value});
+      } else if constexpr (index::size != 0) {
+         if (field_ != index::size) {
+            mp11::mp_with_index<index::size>(field_, [&](auto i)
+            {
+               using field = mp11::mp_at<fields, decltype(i)>;
+               boost_redis_from_bulk(result.*field::pointer, nd.value, ec);
+            });
+         }
+      }
+
+      on_key_ = !on_key_;
+   }
+};
+
+} // boost::redis::adapter::detail
+
+namespace boost::redis
+{
+
+/** @brief Appends a command whose arguments are the fields of a struct.
+ *  @ingroup high-level-api
+ *
+ *  The public members of `obj`, described with Boost.Describe, are
+ *  added as field-value pairs after the key, for example
+ *
+ *  @code
+ *  struct user {
+ *     std::string name;
+ *     int age;
+ *  };
+ *
+ *  BOOST_DESCRIBE_STRUCT(user, (), (name, age))
+ *
+ *  template <>
+ *  struct boost::redis::is_described_struct<user> : std::true_type {};
+ *
+ *  request req;
+ *  push_struct(req, "HSET", "user:1", user{"Joao", 58});
+ *  req.push("HGETALL", "user:1");
+ *
+ *  response<ignore_t, user> resp;
+ *  @endcode
+ *
+ *  With `is_described_struct` the reply to `HGETALL` is read directly into the struct,
+ *  matching fields by name with a perfect hash computed at compile
+ *  time. Members are converted with `boost_redis_to_bulk` and
+ *  `boost_redis_from_bulk`.
+ *
+ *  @param req The request.
+ *  @param cmd The command e.g. `HSET`.
+ *  @param key The key.
+ *  @param obj The object.
+ */
+template <class T>
+void push_struct(request& req, std::string_view cmd, std::string_view key, T const& obj)
+{
+   static_assert(mp11::mp_size<detail::described_fields<T>>::value != 0, "The struct has no described public members.");
+
+   detail::struct_fields<T> const fields{&obj};
+   req.push_range(cmd, key, &fields, &fields + 1);
+}
+
+} // boost::redis
+
+#endif // BOOST_REDIS_DESCRIBE_HPP
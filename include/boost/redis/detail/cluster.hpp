@@ -0,0 +1,186 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_DETAIL_CLUSTER_HPP
+#define BOOST_REDIS_DETAIL_CLUSTER_HPP
+
+#include <boost/redis/config.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/detail/raw_replies.hpp>
+#include <boost/redis/resp3/node.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+// Number of hash slots in a Redis Cluster.
+inline constexpr std::size_t cluster_slots = 16384;
+
+// CRC16-CCITT (XMODEM) as used by Redis Cluster.
+auto crc16(std::string_view data) noexcept -> std::uint16_t;
+
+// Returns the hash slot of the key, taking hash tags i.e. {...}
+// into account.
+auto get_hash_slot(std::string_view key) noexcept -> std::size_t;
+
+// A command of a request. The views point into the request
+// payload, payload is the serialized command.
+struct cluster_command {
+   std::string_view name;
+   std::vector<std::string_view> args;
+   std::string_view payload;
+};
+
+// Splits the request payload into its commands.
+void
+parse_commands(
+   std::string_view payload,
+   std::vector<cluster_command>& cmds,
+   system::error_code& ec);
+
+// Returns the key used to route the command, if any.
+auto get_command_key(cluster_command const& cmd) -> std::optional<std::string_view>;
+
+// Commands that must be sent to the same node, usually a single
+// command or a MULTI/EXEC block. Commands are in [first, last).
+struct cluster_unit {
+   std::size_t first = 0;
+   std::size_t last = 0;
+   std::optional<std::size_t> slot;
+};
+
+// Groups the commands in units and computes their hash slots.
+void
+make_units(
+   std::vector<cluster_command> const& cmds,
+   std::vector<cluster_unit>& units);
+
+// Appends the commands of the unit to the request.
+void
+append_unit(
+   request& req,
+   std::vector<cluster_command> const& cmds,
+   cluster_unit const& unit);
+
+// An entry of the CLUSTER SLOTS response. The slot range is
+// inclusive.
+struct cluster_slot_range {
+   std::size_t begin = 0;
+   std::size_t end = 0;
+   address primary;
+   std::vector<address> replicas;
+};
+
+// Parses the response to CLUSTER SLOTS. Empty hosts are replaced
+// by default_host as they refer to the node that sent the response.
+void
+parse_cluster_slots(
+   std::vector<resp3::node> const& nodes,
+   std::string_view default_host,
+   std::vector<cluster_slot_range>& ranges,
+   system::error_code& ec);
+
+// A MOVED or ASK error.
+struct redirection {
+   bool ask = false;
+   std::size_t slot = 0;
+   address addr;
+};
+
+// Parses the message of a MOVED or ASK error e.g. "MOVED 3999
+// 127.0.0.1:6381". Returns an empty optional for other errors.
+auto
+parse_redirection(
+   std::string_view msg,
+   std::string_view default_host) -> std::optional<redirection>;
+
+// The part of a request sent to one node.
+struct cluster_subrequest {
+   std::size_t node = 0;
+   request req;
+   raw_replies replies;
+
+   // The unit and the position in the original request of each
+   // response. ASKING has no position.
+   struct origin {
+      std::size_t unit;
+      std::optional<std::size_t> index;
+   };
+   std::vector<origin> origins;
+};
+
+struct cluster_exec_state {
+   std::vector<cluster_command> cmds;
+   std::vector<cluster_unit> units;
+
+   // Position in the request of the first response of each unit.
+   std::vector<std::size_t> first_response;
+
+   // Units to send in the current round and the redirection that
+   // sent them there, if any.
+   std::vector<std::size_t> pending;
+   std::vector<std::optional<redirection>> redirections;
+
+   std::vector<cluster_subrequest> subs;
+
+   // The final replies, indexed by their position in the request.
+   std::vector<std::vector<resp3::node>> replies;
+   std::size_t size = 0;
+};
+
+// The address of each node known to a cluster connection and the
+// node of each hash slot. Splits requests by node and follows the
+// redirections in their replies without doing any I/O, the
+// connection sends the subrequests and creates a connection for
+// each node added here. Nodes are identified by their position and
+// never removed, the first one is the node passed in the config.
+class cluster_router {
+public:
+   cluster_router();
+
+   void set_seed(address const& addr)
+      { nodes_.front() = addr; }
+
+   [[nodiscard]] auto get_nodes() const noexcept
+      { return std::size(nodes_); }
+
+   [[nodiscard]] auto get_address(std::size_t i) const -> address const&
+      { return nodes_[i]; }
+
+   [[nodiscard]] auto get_slot_node(std::size_t slot) const -> std::size_t
+      { return slots_[slot]; }
+
+   // Returns the position of the node, adding it if unknown.
+   auto find_or_add_node(address const& addr) -> std::size_t;
+
+   // Assigns the slot ranges of a CLUSTER SLOTS response.
+   void set_slots(std::vector<cluster_slot_range> const& ranges);
+
+   // Splits the request in units, all of them pending.
+   void init_exec(request const& req, cluster_exec_state& st, system::error_code& ec) const;
+
+   // Builds one subrequest per node with the pending units.
+   void make_subrequests(request const& req, cluster_exec_state& st);
+
+   // Moves the replies of the subrequests to their position in the
+   // request, units with a redirection are pending again. Returns
+   // true on MOVED, which means the slot map is outdated.
+   auto on_subrequests(cluster_exec_state& st, bool follow_redirections) -> bool;
+
+private:
+   std::vector<address> nodes_;
+   std::vector<std::size_t> slots_;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_DETAIL_CLUSTER_HPP
@@ -12,10 +12,14 @@
 #include <boost/redis/error.hpp>
 #include <boost/redis/operation.hpp>
 #include <boost/redis/request.hpp>
+#include <boost/redis/response.hpp>
 #include <boost/redis/resp3/type.hpp>
 #include <boost/redis/config.hpp>
 #include <boost/redis/detail/runner.hpp>
+#include <boost/redis/detail/timer_wheel.hpp>
 #include <boost/redis/usage.hpp>
+#include <boost/redis/metrics.hpp>
+#include <boost/redis/observer.hpp>
 
 #include <boost/system.hpp>
 #include <boost/asio/basic_stream_socket.hpp>
@@ -27,18 +31,21 @@
 #include <boost/assert.hpp>
 #include <boost/core/ignore_unused.hpp>
 #include <boost/asio/ssl/stream.hpp>
+#include <boost/asio/read.hpp>
 #include <boost/asio/read_until.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/experimental/channel.hpp>
+#include <boost/intrusive/list.hpp>
 
 #include <algorithm>
 #include <array>
 #include <chrono>
-#include <deque>
+#include <limits>
 #include <memory>
 #include <string_view>
 #include <type_traits>
 #include <functional>
+#include <vector>
 
 namespace boost::redis::detail
 {
@@ -109,6 +116,8 @@ struct exec_op {
    using adapter_type = typename Conn::adapter_type;
 
    Conn* conn_ = nullptr;
+   request const* req_ = nullptr;
+   adapter_type adapter_;
    std::shared_ptr<req_info_type> info_ = nullptr;
    asio::coroutine coro{};
 
@@ -117,41 +126,51 @@ struct exec_op {
    {
       BOOST_ASIO_CORO_REENTER (coro)
       {
+         // Acquired here rather than in async_exec so that metrics
+         // and events are only recorded for operations that start.
+         // Each enqueue_event is then paired with the
+         // completion_event sent by complete.
+         info_ = conn_->acquire_request_info(*req_, std::move(adapter_));
+         conn_->notify(*info_, [&](auto id) { return enqueue_event{id, event_clock::now(), req_}; });
+
          // Check whether the user wants to wait for the connection to
          // be stablished.
          if (info_->req_->get_config().cancel_if_not_connected && !conn_->is_open()) {
             BOOST_ASIO_CORO_YIELD
             asio::post(std::move(self));
-            return self.complete(error::not_connected, 0);
+            return complete(self, error::not_connected, 0);
          }
 
-         conn_->add_request_info(info_);
+         conn_->add_request_info(*info_);
 
 EXEC_OP_WAIT:
          BOOST_ASIO_CORO_YIELD
          info_->async_wait(std::move(self));
-         BOOST_ASSERT(ec == asio::error::operation_aborted);
+         BOOST_ASSERT(!ec || ec == asio::error::operation_aborted || is_cancelled(self));
 
          if (info_->ec_) {
-            self.complete(info_->ec_, 0);
+            complete(self, info_->ec_, 0);
             return;
          }
 
          if (info_->stop_requested()) {
             // Don't have to call remove_request as it has already
             // been by cancel(exec).
-            return self.complete(ec, 0);
+            return complete(self, asio::error::operation_aborted, 0);
          }
 
          if (is_cancelled(self)) {
-            if (info_->is_written()) {
+            // Staged requests are in the middle of a write and their
+            // payload might be referenced by the write buffers, so
+            // they are treated as written.
+            if (!info_->is_waiting_write()) {
                using c_t = asio::cancellation_type;
                auto const c = self.get_cancellation_state().cancelled();
                if ((c & c_t::terminal) != c_t::none) {
                   // Cancellation requires closing the connection
                   // otherwise it stays in inconsistent state.
                   conn_->cancel(operation::run);
-                  return self.complete(ec, 0);
+                  return complete(self, asio::error::operation_aborted, 0);
                } else {
                   // Can't implement other cancelation types, ignoring.
                   self.get_cancellation_state().clear();
@@ -162,15 +181,25 @@ EXEC_OP_WAIT:
                }
             } else {
                // Cancelation can be honored.
-               conn_->remove_request(info_);
-               self.complete(ec, 0);
+               conn_->remove_request(*info_);
+               complete(self, asio::error::operation_aborted, 0);
                return;
             }
          }
 
-         self.complete(info_->ec_, info_->read_size_);
+         complete(self, info_->ec_, info_->read_size_);
       }
    }
+
+   // Returns the request info to the connection pool before
+   // completing.
+   template <class Self>
+   void complete(Self& self, system::error_code ec, std::size_t n)
+   {
+      conn_->notify(*info_, [&](auto id) { return completion_event{id, event_clock::now(), ec, n}; });
+      conn_->release_request_info(std::move(info_));
+      self.complete(ec, n);
+   }
 };
 
 template <class Conn, class Logger>
@@ -225,17 +254,15 @@ struct writer_op {
                   , system::error_code ec = {}
                   , std::size_t n = 0)
    {
-      ignore_unused(n);
-
       BOOST_ASIO_CORO_REENTER (coro) for (;;)
       {
          while (conn_->coalesce_requests()) {
             if (conn_->use_ssl())
-               BOOST_ASIO_CORO_YIELD asio::async_write(conn_->next_layer(), asio::buffer(conn_->write_buffer_), std::move(self));
+               BOOST_ASIO_CORO_YIELD asio::async_write(conn_->next_layer(), conn_->write_buffers_, std::move(self));
             else
-               BOOST_ASIO_CORO_YIELD asio::async_write(conn_->next_layer().next_layer(), asio::buffer(conn_->write_buffer_), std::move(self));
+               BOOST_ASIO_CORO_YIELD asio::async_write(conn_->next_layer().next_layer(), conn_->write_buffers_, std::move(self));
 
-            logger_.on_write(ec, conn_->write_buffer_);
+            logger_.on_write(ec, n);
 
             if (ec) {
                logger_.trace("writer-op: error. Exiting ...");
@@ -296,7 +323,23 @@ struct reader_op {
       {
          // Appends some data to the buffer if necessary.
          if ((res_.first == parse_result::needs_more) || std::empty(conn_->read_buffer_)) {
-            if (conn_->use_ssl()) {
+            if (res_.first == parse_result::needs_more && conn_->prepare_direct_read()) {
+               // Reads the rest of a large blob string directly
+               // into the response.
+               if (conn_->use_ssl()) {
+                  BOOST_ASIO_CORO_YIELD
+                  asio::async_read(
+                     conn_->next_layer(),
+                     conn_->direct_read_buffer_,
+                     std::move(self));
+               } else {
+                  BOOST_ASIO_CORO_YIELD
+                  asio::async_read(
+                     conn_->next_layer().next_layer(),
+                     conn_->direct_read_buffer_,
+                     std::move(self));
+               }
+            } else if (conn_->use_ssl()) {
                BOOST_ASIO_CORO_YIELD
                async_append_some(
                   conn_->next_layer(),
@@ -348,6 +391,8 @@ struct reader_op {
          }
 
          if (res_.first == parse_result::push) {
+            // The channel is unbounded, its capacity is enforced by
+            // the push policy below.
             if (!conn_->receive_channel_.try_send(ec, res_.second)) {
                BOOST_ASIO_CORO_YIELD
                conn_->receive_channel_.async_send(ec, res_.second, std::move(self));
@@ -360,6 +405,21 @@ struct reader_op {
                return;
             }
 
+            conn_->on_push_sent(res_.second);
+
+            // Waits until the push consumer catches up.
+            while (conn_->must_wait_push_consumer()) {
+               conn_->push_timer_.expires_at((std::chrono::steady_clock::time_point::max)());
+               BOOST_ASIO_CORO_YIELD
+               conn_->push_timer_.async_wait(std::move(self));
+
+               if (!conn_->is_open() || is_cancelled(self)) {
+                  logger_.trace("reader-op: canceled (3). Exiting ...");
+                  self.complete(asio::error::operation_aborted);
+                  return;
+               }
+            }
+
             if (!conn_->is_open() || is_cancelled(self)) {
                logger_.trace("reader-op: canceled (2). Exiting ...");
                self.complete(asio::error::operation_aborted);
@@ -371,13 +431,66 @@ struct reader_op {
    }
 };
 
+template <class Conn>
+struct receive_op {
+   Conn* conn_ = nullptr;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t n = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro)
+      {
+         BOOST_ASIO_CORO_YIELD
+         conn_->receive_channel_.async_receive(std::move(self));
+         if (!ec)
+            conn_->on_push_received(n);
+
+         self.complete(ec, n);
+      }
+   }
+};
+
+// Timestamps of a request and the position of the command whose
+// response is expected next, kept only when metrics are enabled.
+template <class Clock>
+struct request_times {
+   typename Clock::time_point exec;
+   typename Clock::time_point staged;
+   typename Clock::time_point written;
+   std::size_t command_pos = 0;
+};
+
+struct no_request_times {};
+
+// The request id and whether its first response has been seen, kept
+// only when an observer is installed.
+struct request_trace {
+   std::uint64_t id = 0;
+   bool first_byte = false;
+};
+
+struct no_request_trace {};
+
+// Adapter of the placeholders that take the place of requests that
+// timed out after being written, see discard_response.
+struct discard_adapter {
+   template <class Nodes>
+   void operator()(std::size_t, Nodes const&, system::error_code&) noexcept { }
+
+   auto get_bulk_destination(std::size_t) noexcept -> std::string*
+      { return nullptr; }
+};
+
 /** @brief Base class for high level Redis asynchronous connections.
  *  @ingroup high-level-api
  *
  *  @tparam Executor The executor type.
+ *  @tparam Metrics The metrics policy, see `latency_metrics`.
+ *  @tparam Observer Receives the request events, see `basic_connection`.
  *
  */
-template <class Executor>
+template <class Executor, class Metrics = no_metrics, class Observer = no_observer>
 class connection_base {
 public:
    /// Executor type
@@ -390,7 +503,7 @@ public:
    using clock_traits_type = asio::wait_traits<clock_type>;
    using timer_type = asio::basic_waitable_timer<clock_type, clock_traits_type, executor_type>;
 
-   using this_type = connection_base<Executor>;
+   using this_type = connection_base<Executor, Metrics, Observer>;
 
    /// Constructs from an executor.
    connection_base(
@@ -400,9 +513,11 @@ public:
    : ctx_{method}
    , stream_{std::make_unique<next_layer_type>(ex, ctx_)}
    , writer_timer_{ex}
-   , receive_channel_{ex, 256}
+   , push_timer_{ex}
+   , receive_channel_{ex, (std::numeric_limits<std::size_t>::max)()}
    , runner_{ex, {}}
    , dbuf_{read_buffer_, max_read_size}
+   , deadline_timer_{ex}
    {
       set_receive_response(ignore);
       writer_timer_.expires_at((std::chrono::steady_clock::time_point::max)());
@@ -452,12 +567,10 @@ public:
       auto f = boost_redis_adapt(resp);
       BOOST_ASSERT_MSG(req.get_expected_responses() <= f.get_supported_response_size(), "Request and response have incompatible sizes.");
 
-      auto info = std::make_shared<req_info>(req, f, get_executor());
-
       return asio::async_compose
          < CompletionToken
          , void(system::error_code, std::size_t)
-         >(exec_op<this_type>{this, info}, token, writer_timer_);
+         >(exec_op<this_type>{this, &req, adapter_type{adapter::detail::make_batch_adapter(f)}}, token, writer_timer_);
    }
 
    template <class Response, class CompletionToken>
@@ -465,12 +578,17 @@ public:
    auto async_receive(Response& response, CompletionToken token)
    {
       set_receive_response(response);
-      return receive_channel_.async_receive(std::move(token));
+      return async_receive(std::move(token));
    }
 
    template <class CompletionToken>
    auto async_receive(CompletionToken token)
-      { return receive_channel_.async_receive(std::move(token)); }
+   {
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(receive_op<this_type>{this}, token, writer_timer_);
+   }
 
    std::size_t receive(system::error_code& ec)
    {
@@ -486,9 +604,12 @@ public:
       if (ec)
          return 0;
 
-      if (!res)
+      if (!res) {
          ec = error::sync_receive_push_failed;
+         return 0;
+      }
 
+      on_push_received(size);
       return size;
    }
 
@@ -506,67 +627,101 @@ public:
       using namespace boost::redis::adapter;
       auto g = boost_redis_adapt(response);
       receive_adapter_ = adapter::detail::make_adapter_wrapper(g);
+
+      // Used by push_policy::drop_oldest.
+      if constexpr (std::is_same_v<Response, generic_response> || std::is_same_v<Response, generic_queue_response>)
+         consume_oldest_push_ = [&response]() { consume_one(response); };
+      else
+         consume_oldest_push_ = nullptr;
    }
 
    usage get_usage() const noexcept
-      { return usage_; }
+   {
+      auto ret = usage_;
+      ret.read_buffer_capacity = read_buffer_.capacity();
+      ret.pushes_queued = pushes_pending_;
+
+      auto const& checker = runner_.get_health_checker();
+      ret.health_check_pings = checker.get_pings();
+      ret.health_check_rtt = checker.get_rtt();
+      ret.health_check_srtt = checker.get_srtt();
+      return ret;
+   }
+
+   // Used by the health checker as proof of liveness.
+   auto get_received_messages() const noexcept -> std::size_t
+      { return usage_.responses_received + usage_.pushes_received; }
+
+   auto get_metrics() const noexcept -> Metrics const&
+      { return metrics_; }
+
+   auto get_observer() noexcept -> Observer&
+      { return observer_; }
+
+   auto get_observer() const noexcept -> Observer const&
+      { return observer_; }
 
 private:
    using receive_channel_type = asio::experimental::channel<executor_type, void(system::error_code, std::size_t)>;
    using runner_type = runner<executor_type>;
-   using adapter_type = std::function<void(std::size_t, resp3::basic_node<std::string_view> const&, system::error_code&)>;
-   using receiver_adapter_type = std::function<void(resp3::basic_node<std::string_view> const&, system::error_code&)>;
+   using node_type = resp3::basic_node<std::string_view>;
+   using nodes_type = std::vector<node_type>;
+
+   // Adapters receive all nodes of a message at once, see the batch
+   // overload of resp3::parse.
+   using adapter_type = adapter::detail::any_adapter;
+   using receiver_adapter_type = std::function<void(nodes_type const&, system::error_code&)>;
 
    auto use_ssl() const noexcept
       { return runner_.get_config().use_ssl;}
 
    auto cancel_on_conn_lost() -> std::size_t
    {
-      // Must return false if the request should be removed.
-      auto cond = [](auto const& ptr)
+      std::size_t ret = 0;
+      auto const stop = [&ret](req_info* ptr)
       {
-         BOOST_ASSERT(ptr != nullptr);
-
-         if (ptr->is_written()) {
-            return !ptr->req_->get_config().cancel_if_unresponded;
-         } else {
-            return !ptr->req_->get_config().cancel_on_connection_lost;
-         }
+         // Placeholders of discarded responses are not user requests.
+         if (!ptr->discard_)
+            ++ret;
+         ptr->stop();
       };
 
-      auto point = std::stable_partition(std::begin(reqs_), std::end(reqs_), cond);
+      written_.remove_and_dispose_if([](auto const& e) {
+         return e.req_->get_config().cancel_if_unresponded;
+      }, stop);
 
-      auto const ret = std::distance(point, std::end(reqs_));
+      auto const cond = [](auto const& e)
+         { return e.req_->get_config().cancel_on_connection_lost; };
 
-      std::for_each(point, std::end(reqs_), [](auto const& ptr) {
-         ptr->stop();
-      });
+      staged_.remove_and_dispose_if(cond, stop);
+      waiting_.remove_and_dispose_if(cond, stop);
 
-      reqs_.erase(point, std::end(reqs_));
-      std::for_each(std::begin(reqs_), std::end(reqs_), [](auto const& ptr) {
-         return ptr->reset_status();
-      });
+      // The remaining requests will be written again after
+      // reconnection, in the same order.
+      for (auto& e: written_)
+         e.reset_status();
+      for (auto& e: staged_)
+         e.reset_status();
+
+      waiting_.splice(std::cbegin(waiting_), staged_);
+      waiting_.splice(std::cbegin(waiting_), written_);
+
+      // Placeholders of discarded responses are always removed above.
+      reclaim_discarded();
 
       return ret;
    }
 
    auto cancel_unwritten_requests() -> std::size_t
    {
-      auto f = [](auto const& ptr)
-      {
-         BOOST_ASSERT(ptr != nullptr);
-         return ptr->is_written();
-      };
-
-      auto point = std::stable_partition(std::begin(reqs_), std::end(reqs_), f);
-
-      auto const ret = std::distance(point, std::end(reqs_));
-
-      std::for_each(point, std::end(reqs_), [](auto const& ptr) {
+      // Staged requests can't be removed since they are being
+      // written.
+      std::size_t ret = 0;
+      waiting_.clear_and_dispose([&ret](req_info* ptr) {
          ptr->stop();
+         ++ret;
       });
 
-      reqs_.erase(point, std::end(reqs_));
       return ret;
    }
 
@@ -581,6 +736,7 @@ private:
          {
             close();
             writer_timer_.cancel();
+            push_timer_.cancel();
             receive_channel_.cancel();
             cancel_on_conn_lost();
          } break;
@@ -594,26 +750,46 @@ private:
 
    void on_write()
    {
-      // We have to clear the payload right after writing it to use it
-      // as a flag that informs there is no ongoing write.
+      // We have to clear the buffers right after writing them to use
+      // them as a flag that informs there is no ongoing write.
       write_buffer_.clear();
+      write_buffers_.clear();
 
-      // Notice this must come before the for-each below.
+      // Notice this must come before the loop below.
       cancel_push_requests();
 
-      // There is small optimization possible here: traverse only the
-      // partition of unwritten requests instead of them all.
-      std::for_each(std::begin(reqs_), std::end(reqs_), [](auto const& ptr) {
-         BOOST_ASSERT_MSG(ptr != nullptr, "Expects non-null pointer.");
-         if (ptr->is_staged())
-            ptr->mark_written();
-      });
+      if constexpr (Metrics::enabled) {
+         auto const now = clock_type::now();
+         for (auto& e: staged_) {
+            metrics_.record_write(now - e.times_.staged);
+            e.times_.written = now;
+         }
+      }
+
+      if constexpr (is_observed<Observer>) {
+         auto const now = event_clock::now();
+         for (auto& e: staged_) {
+            e.trace_.first_byte = false;
+            observer_.on_event(write_event{e.trace_.id, now});
+         }
+      }
+
+      for (auto& e: staged_)
+         e.mark_written();
+
+      written_.splice(std::cend(written_), staged_);
    }
 
-   struct req_info {
+   // Nodes are pooled by the connection and linked in one of the
+   // request lists according to their status, see release_request_info.
+   struct req_info
+      : intrusive::list_base_hook<intrusive::link_mode<intrusive::auto_unlink>>
+      , timer_wheel_node {
    public:
-      using node_type = resp3::basic_node<std::string_view>;
-      using wrapped_adapter_type = std::function<void(node_type const&, system::error_code&)>;
+      // Used to wake up the exec_op. A single slot channel doesn't
+      // need to go through the timer queue as a cancelled timer
+      // does and notifying it does not suspend.
+      using event_type = asio::experimental::channel<executor_type, void(system::error_code)>;
 
       enum class action
       {
@@ -622,34 +798,35 @@ private:
          none,
       };
 
-      explicit req_info(request const& req, adapter_type adapter, executor_type ex)
-      : timer_{ex}
-      , action_{action::none}
-      , req_{&req}
-      , adapter_{}
-      , expected_responses_{req.get_expected_responses()}
-      , status_{status::none}
-      , ec_{{}}
-      , read_size_{0}
-      {
-         timer_.expires_at((std::chrono::steady_clock::time_point::max)());
+      explicit req_info(executor_type ex)
+      : event_{ex, 1}
+      { }
 
-         adapter_ = [this, adapter](node_type const& nd, system::error_code& ec)
-         {
-            auto const i = req_->get_expected_responses() - expected_responses_;
-            adapter(i, nd, ec);
-         };
+      // Prepares the node for a new request.
+      void prepare(request const& req, adapter_type adapter)
+      {
+         // Drops notifications that arrived after the previous
+         // request has completed.
+         event_.reset();
+         action_ = action::none;
+         req_ = &req;
+         adapter_ = std::move(adapter);
+         expected_responses_ = req.get_expected_responses();
+         status_ = status::none;
+         ec_ = {};
+         read_size_ = 0;
+         discard_ = false;
       }
 
       auto proceed()
       {
-         timer_.cancel();
+         event_.try_send(system::error_code{});
          action_ = action::proceed;
       }
 
       void stop()
       {
-         timer_.cancel();
+         event_.try_send(asio::error::operation_aborted);
          action_ = action::stop;
       }
 
@@ -674,10 +851,14 @@ private:
       [[nodiscard]] auto stop_requested() const noexcept
          { return action_ == action::stop;}
 
+      // The index of the command whose response is being read.
+      [[nodiscard]] auto get_response_index() const noexcept
+         { return req_->get_expected_responses() - expected_responses_; }
+
       template <class CompletionToken>
       auto async_wait(CompletionToken token)
       {
-         return timer_.async_wait(std::move(token));
+         return event_.async_receive(std::move(token));
       }
 
    //private:
@@ -687,64 +868,226 @@ private:
       , written
       };
 
-      timer_type timer_;
-      action action_;
-      request const* req_;
-      wrapped_adapter_type adapter_;
+      event_type event_;
+      action action_ = action::none;
+      request const* req_ = nullptr;
+      adapter_type adapter_;
 
       // Contains the number of commands that haven't been read yet.
-      std::size_t expected_responses_;
-      status status_;
+      std::size_t expected_responses_ = 0;
+      status status_ = status::none;
 
       system::error_code ec_;
-      std::size_t read_size_;
+      std::size_t read_size_ = 0;
+
+      // True for the placeholders of discarded responses.
+      bool discard_ = false;
+
+      std::conditional_t<Metrics::enabled, request_times<clock_type>, no_request_times> times_;
+      std::conditional_t<is_observed<Observer>, request_trace, no_request_trace> trace_;
    };
 
-   void remove_request(std::shared_ptr<req_info> const& info)
+   using req_list_type = intrusive::list<req_info, intrusive::constant_time_size<false>>;
+
+   auto acquire_request_info(request const& req, adapter_type adapter) -> std::shared_ptr<req_info>
    {
-      reqs_.erase(std::remove(std::begin(reqs_), std::end(reqs_), info));
+      std::shared_ptr<req_info> info;
+      if (std::empty(req_pool_)) {
+         info = std::make_shared<req_info>(get_executor());
+      } else {
+         info = std::move(req_pool_.back());
+         req_pool_.pop_back();
+      }
+
+      info->prepare(req, std::move(adapter));
+
+      if constexpr (Metrics::enabled) {
+         info->times_ = {clock_type::now(), {}, {}, 0};
+         metrics_.on_exec();
+      }
+
+      if constexpr (is_observed<Observer>)
+         info->trace_ = {++last_request_id_, false};
+
+      return info;
    }
 
-   using reqs_type = std::deque<std::shared_ptr<req_info>>;
+   void release_request_info(std::shared_ptr<req_info> info)
+   {
+      // The request might still be linked e.g. on errors.
+      if (info->is_linked())
+         info->unlink();
+
+      // Lets io_context::run return when no deadline is left.
+      deadlines_.cancel(*info);
+      if (deadlines_.empty() && deadline_armed_) {
+         deadline_armed_ = false;
+         deadline_timer_.cancel();
+      }
+
+      info->req_ = nullptr;
+      info->adapter_.reset();
+      req_pool_.push_back(std::move(info));
+
+      if constexpr (Metrics::enabled)
+         metrics_.on_done();
+   }
+
+   void remove_request(req_info& info)
+   {
+      info.unlink();
+   }
+
+   // Sends the event returned by f(id) to the observer. Nothing is
+   // evaluated without an observer.
+   template <class F>
+   void notify(req_info const& ri, F f)
+   {
+      if constexpr (is_observed<Observer>)
+         observer_.on_event(f(ri.trace_.id));
+   }
 
    template <class, class> friend struct reader_op;
    template <class, class> friend struct writer_op;
    template <class, class> friend struct run_op;
    template <class> friend struct exec_op;
+   template <class> friend struct receive_op;
    template <class, class, class> friend struct run_all_op;
 
    void cancel_push_requests()
    {
-      auto point = std::stable_partition(std::begin(reqs_), std::end(reqs_), [](auto const& ptr) {
-         return !(ptr->is_staged() && ptr->req_->get_expected_responses() == 0);
-      });
-
-      std::for_each(point, std::end(reqs_), [](auto const& ptr) {
+      // Requests that don't expect a response are done once written.
+      staged_.remove_and_dispose_if([](auto const& e) {
+         return e.req_->get_expected_responses() == 0;
+      }, [](req_info* ptr) {
          ptr->proceed();
       });
-
-      reqs_.erase(point, std::end(reqs_));
    }
 
    [[nodiscard]] bool is_writing() const noexcept
    {
-      return !write_buffer_.empty();
+      return !write_buffers_.empty();
    }
 
-   void add_request_info(std::shared_ptr<req_info> const& info)
+   void add_request_info(req_info& info)
    {
-      reqs_.push_back(info);
+      // Requests with hello priority are written before the ones
+      // still waiting.
+      if (info.req_->has_hello_priority())
+         waiting_.push_front(info);
+      else
+         waiting_.push_back(info);
 
-      if (info->req_->has_hello_priority()) {
-         auto rend = std::partition_point(std::rbegin(reqs_), std::rend(reqs_), [](auto const& e) {
-               return e->is_waiting_write();
-         });
+      if (is_open() && !is_writing())
+         writer_timer_.cancel();
 
-         std::rotate(std::rbegin(reqs_), std::rbegin(reqs_) + 1, rend);
+      auto const timeout = info.req_->get_config().timeout;
+      if (timeout > clock_type::duration::zero()) {
+         deadlines_.schedule(info, clock_type::now() + timeout);
+         arm_deadline_timer();
       }
+   }
 
-      if (is_open() && !is_writing())
-         writer_timer_.cancel();
+   // A single timer is armed at the first deadline of the wheel.
+   void arm_deadline_timer()
+   {
+      auto const next = deadlines_.next_expiry();
+      if (deadline_armed_ && deadline_timer_.expiry() <= next)
+         return;
+
+      // Cancels the previous wait, if any.
+      deadline_timer_.expires_at(next);
+      deadline_armed_ = true;
+      // The completion may already be queued with success when the
+      // connection is destroyed, hence the weak handle.
+      std::weak_ptr<this_type*> self = deadline_self_;
+      deadline_timer_.async_wait([self](system::error_code ec) {
+         auto const conn = self.lock();
+         if (!conn || ec == asio::error::operation_aborted)
+            return;
+
+         (*conn)->deadline_armed_ = false;
+         (*conn)->on_deadline();
+      });
+   }
+
+   void on_deadline()
+   {
+      deadlines_.advance(clock_type::now(), [this](timer_wheel_node& node) {
+         on_request_timeout(static_cast<req_info&>(node));
+      });
+
+      if (!deadlines_.empty())
+         arm_deadline_timer();
+   }
+
+   void on_request_timeout(req_info& ri)
+   {
+      // Completion is already on its way.
+      if (ri.action_ != req_info::action::none)
+         return;
+
+      if (ri.is_waiting_write()) {
+         ri.unlink();
+         ri.ec_ = error::request_timeout;
+         ri.proceed();
+         return;
+      }
+
+      // Staged payloads are referenced by the ongoing write and a
+      // direct read writes into the response, so they are checked
+      // again in the next tick.
+      auto const reading_into = direct_read_size_ != 0 && &written_.front() == &ri;
+      if (ri.is_staged() || reading_into) {
+         deadlines_.schedule(ri, clock_type::now() + deadlines_.get_resolution());
+         return;
+      }
+
+      discard_response(ri);
+   }
+
+   // Completes a written request with request_timeout. A placeholder
+   // takes its place in written_ so that its remaining responses are
+   // read and discarded, which keeps the connection usable.
+   void discard_response(req_info& ri)
+   {
+      std::shared_ptr<req_info> ph;
+      if (std::empty(req_pool_)) {
+         ph = std::make_shared<req_info>(get_executor());
+      } else {
+         ph = std::move(req_pool_.back());
+         req_pool_.pop_back();
+      }
+
+      ph->prepare(discard_req_, adapter_type{discard_adapter{}});
+      ph->expected_responses_ = ri.expected_responses_;
+      ph->mark_written();
+      ph->discard_ = true;
+
+      written_.insert(written_.iterator_to(ri), *ph);
+      discarded_.push_back(std::move(ph));
+
+      ri.unlink();
+      ri.ec_ = error::request_timeout;
+      ri.proceed();
+   }
+
+   // Returns the placeholders that are not linked anymore to the
+   // pool.
+   void reclaim_discarded()
+   {
+      auto iter = std::begin(discarded_);
+      while (iter != std::end(discarded_)) {
+         if ((*iter)->is_linked()) {
+            ++iter;
+            continue;
+         }
+
+         (*iter)->req_ = nullptr;
+         (*iter)->adapter_.reset();
+         req_pool_.push_back(std::move(*iter));
+         iter = discarded_.erase(iter);
+      }
    }
 
    template <class CompletionToken, class Logger>
@@ -776,29 +1119,103 @@ private:
          >(run_op<this_type, Logger>{this, l}, token, writer_timer_);
    }
 
+   // Max number of buffers passed to a single write, more than that
+   // would be split by asio in multiple writev calls anyway.
+   static constexpr std::size_t max_write_buffers = 64;
+
    [[nodiscard]] bool coalesce_requests()
    {
       // Coalesces the requests and marks them staged. After a
       // successful write staged requests will be marked as written.
-      auto const point = std::partition_point(std::cbegin(reqs_), std::cend(reqs_), [](auto const& ri) {
-            return !ri->is_waiting_write();
-      });
+      //
+      // Payloads smaller than the copy threshold are copied into
+      // write_buffer_ while larger ones are referenced directly, so
+      // they are written without an extra copy. Requests that don't
+      // fit in max_write_buffers stay waiting for the next write.
+      BOOST_ASSERT(std::empty(staged_));
+
+      auto const point = std::begin(waiting_);
+
+      auto const threshold = runner_.get_config().write_copy_threshold;
+      auto const is_large = [threshold](auto const& ri)
+         { return std::size(ri.req_->payload()) >= threshold; };
+
+      // First pass: finds the requests that fit and the size of the
+      // copied part. Consecutive copied payloads take a single
+      // buffer.
+      std::size_t n_buffers = 0;
+      std::size_t copy_size = 0;
+      bool copying = false;
+      auto end = point;
+      for (; end != std::end(waiting_); ++end) {
+         auto const large = is_large(*end);
+         auto const needs_buffer = large || !copying;
+         if (needs_buffer && n_buffers == max_write_buffers)
+            break;
+
+         n_buffers += needs_buffer ? 1 : 0;
+         copying = !large;
+         if (!large)
+            copy_size += std::size(end->req_->payload());
+      }
+
+      // Second pass: builds the buffer sequence. The reserve ensures
+      // the views into write_buffer_ are not invalidated by the
+      // appends.
+      write_buffer_.reserve(copy_size);
+      std::size_t copy_begin = 0;
+      copying = false;
+      std::for_each(point, end, [&](auto& ri) {
+         auto const& payload = ri.req_->payload();
+         if (is_large(ri)) {
+            if (copying)
+               write_buffers_.push_back(asio::buffer(write_buffer_.data() + copy_begin, std::size(write_buffer_) - copy_begin));
+            write_buffers_.push_back(asio::buffer(payload));
+            copying = false;
+         } else {
+            if (!copying)
+               copy_begin = std::size(write_buffer_);
+            write_buffer_ += payload;
+            copying = true;
+         }
 
-      std::for_each(point, std::cend(reqs_), [this](auto const& ri) {
          // Stage the request.
-         write_buffer_ += ri->req_->payload();
-         ri->mark_staged();
-         usage_.commands_sent += ri->expected_responses_;
+         ri.mark_staged();
+         usage_.commands_sent += ri.expected_responses_;
+         usage_.bytes_sent += std::size(payload);
       });
 
-      usage_.bytes_sent += std::size(write_buffer_);
+      if (copying)
+         write_buffers_.push_back(asio::buffer(write_buffer_.data() + copy_begin, std::size(write_buffer_) - copy_begin));
+
+      if constexpr (Metrics::enabled) {
+         // A single timestamp for the whole batch.
+         auto const now = clock_type::now();
+         std::size_t batch_size = 0;
+         std::for_each(point, end, [&](auto& ri) {
+            metrics_.record_queue(now - ri.times_.exec);
+            ri.times_.staged = now;
+            ++batch_size;
+         });
 
-      return point != std::cend(reqs_);
+         metrics_.on_staged(batch_size);
+      }
+
+      if constexpr (is_observed<Observer>) {
+         auto const now = event_clock::now();
+         std::for_each(point, end, [&](auto& ri) {
+            observer_.on_event(stage_event{ri.trace_.id, now});
+         });
+      }
+
+      staged_.splice(std::cend(staged_), waiting_, point, end);
+
+      return !std::empty(staged_);
    }
 
    bool is_waiting_response() const noexcept
    {
-      return !std::empty(reqs_) && reqs_.front()->is_written();
+      return !std::empty(written_);
    }
 
    void close()
@@ -841,17 +1258,85 @@ private:
 
       return
          (resp3::to_type(read_buffer_.front()) == resp3::type::push)
-          || reqs_.empty()
-          || (!reqs_.empty() && reqs_.front()->expected_responses_ == 0)
-          || !is_waiting_response(); // Added to deal with MONITOR.
+          || !is_waiting_response() // Added to deal with MONITOR.
+          || written_.front().expected_responses_ == 0;
    }
 
    auto get_suggested_buffer_growth() const noexcept
    {
-      return parser_.get_suggested_buffer_growth(4096);
+      return parser_.get_suggested_buffer_growth(runner_.get_config().read_buffer_append_size);
+   }
+
+   enum class parse_result { needs_more, push, resp, dropped };
+
+   // Number and size of the pushes sent to the channel and not yet
+   // received.
+   void on_push_sent(std::size_t n) noexcept
+   {
+      pushes_pending_ += 1;
+      push_bytes_pending_ += n;
+
+      auto const& cfg = runner_.get_config();
+      if (cfg.push_overflow == push_policy::spill && pushes_pending_ > cfg.push_channel_capacity)
+         usage_.pushes_spilled += 1;
+   }
+
+   void on_push_received(std::size_t n)
+   {
+      BOOST_ASSERT(pushes_pending_ != 0);
+      pushes_pending_ -= 1;
+      push_bytes_pending_ -= (std::min)(n, push_bytes_pending_);
+
+      // Wakes up the reader if it is waiting.
+      push_timer_.cancel();
    }
 
-   enum class parse_result { needs_more, push, resp };
+   bool must_wait_push_consumer() const noexcept
+   {
+      auto const& cfg = runner_.get_config();
+      if (pushes_pending_ <= cfg.push_channel_capacity)
+         return false;
+
+      switch (cfg.push_overflow) {
+         case push_policy::block: return true;
+         case push_policy::spill: return push_bytes_pending_ > cfg.push_spill_limit;
+         default: return false;
+      }
+   }
+
+   // Called at the start of a push, returns true if it should be
+   // parsed without passing it to the receive adapter.
+   bool must_drop_push()
+   {
+      auto const& cfg = runner_.get_config();
+      if (pushes_pending_ < cfg.push_channel_capacity)
+         return false;
+
+      switch (cfg.push_overflow) {
+         case push_policy::drop_newest: return true;
+         case push_policy::drop_oldest: return !drop_oldest_push();
+         default: return false;
+      }
+   }
+
+   // Removes the oldest push from the channel and the receive
+   // response.
+   bool drop_oldest_push()
+   {
+      if (!consume_oldest_push_)
+         return false;
+
+      std::size_t size = 0;
+      auto f = [&](system::error_code const&, std::size_t n) { size = n; };
+      if (!receive_channel_.try_receive(f))
+         return false;
+
+      consume_oldest_push_();
+      pushes_pending_ -= 1;
+      push_bytes_pending_ -= (std::min)(size, push_bytes_pending_);
+      usage_.pushes_dropped += 1;
+      return true;
+   }
 
    using parse_ret_type = std::pair<parse_result, std::size_t>;
 
@@ -862,16 +1347,74 @@ private:
          usage_.push_bytes_received += parser_.get_consumed();
       } else {
          usage_.responses_received += 1;
-         usage_.response_bytes_received += parser_.get_consumed();
+         usage_.response_bytes_received += parser_.get_consumed() + direct_read_size_;
       }
 
       on_push_ = false;
+      direct_read_size_ = 0;
       dbuf_.consume(parser_.get_consumed());
       auto const res = std::make_pair(t, parser_.get_consumed());
       parser_.reset();
+
+      // An empty buffer means there is no message being read, which
+      // is the moment to release memory from an unusually large
+      // message.
+      if (std::empty(read_buffer_))
+         shrink_read_buffer();
+
       return res;
    }
 
+   // Large top-level blob strings are read directly into the
+   // response when the adapter supports it, which saves copying them
+   // from the read buffer. Returns true if the rest of the blob
+   // should be read into direct_read_buffer_.
+   bool prepare_direct_read()
+   {
+      if (on_push_ || !is_waiting_response())
+         return false;
+
+      if (parser_.get_bulk_type() != resp3::type::blob_string || parser_.get_depth() != 0)
+         return false;
+
+      auto const length = parser_.get_bulk_length();
+      auto const consumed = parser_.get_consumed();
+      auto const available = std::size(read_buffer_) - consumed;
+      if (length < runner_.get_config().direct_read_threshold || length <= available)
+         return false;
+
+      auto& ri = written_.front();
+      auto* dest = ri.adapter_.get_bulk_destination(ri.get_response_index());
+      if (dest == nullptr)
+         return false;
+
+      // Moves the part of the blob that has already been read into
+      // the destination. It is appended to, as boost_redis_from_bulk
+      // does.
+      auto const offset = dest->size();
+      dest->resize(offset + length);
+      std::copy_n(read_buffer_.data() + consumed, available, dest->data() + offset);
+      read_buffer_.erase(consumed);
+      parser_.skip_bulk();
+
+      direct_read_size_ = length;
+      direct_read_buffer_ = asio::buffer(dest->data() + offset + available, length - available);
+      return true;
+   }
+
+   void shrink_read_buffer()
+   {
+      BOOST_ASSERT(std::empty(read_buffer_));
+
+      auto const& cfg = runner_.get_config();
+      if (read_buffer_.capacity() <= cfg.read_buffer_shrink_threshold)
+         return;
+
+      std::string{}.swap(read_buffer_);
+      read_buffer_.reserve(cfg.read_buffer_initial_capacity);
+      usage_.read_buffer_shrinks += 1;
+   }
+
    parse_ret_type on_read(std::string_view data, system::error_code& ec)
    {
       // We arrive here in two states:
@@ -884,11 +1427,29 @@ private:
       //    2. On a new message, in which case we have to determine
       //       whether the next messag is a push or a response.
       //
-      if (!on_push_) // Prepare for new message.
+      usage_.read_buffer_max_size = (std::max)(usage_.read_buffer_max_size, std::size(data));
+      usage_.read_buffer_max_capacity = (std::max)(usage_.read_buffer_max_capacity, read_buffer_.capacity());
+
+      if (!on_push_) { // Prepare for new message.
          on_push_ = is_next_push();
+         drop_push_ = on_push_ && must_drop_push();
+      }
 
       if (on_push_) {
-         if (!resp3::parse(parser_, data, receive_adapter_, ec))
+         if (drop_push_) {
+            auto ignore_adapter = [](nodes_type const&, system::error_code&) { };
+            if (!resp3::parse(parser_, data, nodes_, ignore_adapter, ec))
+               return std::make_pair(parse_result::needs_more, 0);
+
+            if (ec)
+               return std::make_pair(parse_result::dropped, 0);
+
+            usage_.pushes_dropped += 1;
+            auto const res = on_finish_parsing(parse_result::push);
+            return std::make_pair(parse_result::dropped, res.second);
+         }
+
+         if (!resp3::parse(parser_, data, nodes_, receive_adapter_, ec))
             return std::make_pair(parse_result::needs_more, 0);
 
          if (ec)
@@ -898,36 +1459,88 @@ private:
       }
 
       BOOST_ASSERT_MSG(is_waiting_response(), "Not waiting for a response (using MONITOR command perhaps?)");
-      BOOST_ASSERT(!reqs_.empty());
-      BOOST_ASSERT(reqs_.front() != nullptr);
-      BOOST_ASSERT(reqs_.front()->expected_responses_ != 0);
+      auto& ri = written_.front();
+      BOOST_ASSERT(ri.expected_responses_ != 0);
 
-      if (!resp3::parse(parser_, data, reqs_.front()->adapter_, ec))
+      if constexpr (is_observed<Observer>) {
+         if (!ri.discard_ && !ri.trace_.first_byte) {
+            ri.trace_.first_byte = true;
+            observer_.on_event(first_byte_event{ri.trace_.id, event_clock::now()});
+         }
+      }
+
+      auto adapter = [this, &ri](nodes_type const& nodes, system::error_code& ec)
+      {
+         // The content has already been read into the response.
+         if (direct_read_size_ != 0)
+            return;
+
+         ri.adapter_(ri.get_response_index(), nodes, ec);
+      };
+
+      if (!resp3::parse(parser_, data, nodes_, adapter, ec))
          return std::make_pair(parse_result::needs_more, 0);
 
       if (ec) {
-         reqs_.front()->ec_ = ec;
-         reqs_.front()->proceed();
+         ri.ec_ = ec;
+         ri.proceed();
          return std::make_pair(parse_result::resp, 0);
       }
 
-      reqs_.front()->read_size_ += parser_.get_consumed();
+      ri.read_size_ += parser_.get_consumed() + direct_read_size_;
+
+      if (!ri.discard_) {
+         if constexpr (Metrics::enabled)
+            on_response_metrics(ri);
+
+         notify(ri, [&](auto id) { return parse_event{id, event_clock::now(), ri.get_response_index(), parser_.get_consumed() + direct_read_size_}; });
+      }
 
-      if (--reqs_.front()->expected_responses_ == 0) {
+      if (--ri.expected_responses_ == 0) {
          // Done with this request.
-         reqs_.front()->proceed();
-         reqs_.pop_front();
+         ri.proceed();
+         written_.pop_front();
+         if (ri.discard_)
+            reclaim_discarded();
       }
 
       return on_finish_parsing(parse_result::resp);
    }
 
+   // Records the latency of the command whose response has just been
+   // parsed and of the request if it was the last one.
+   void on_response_metrics(req_info& ri)
+   {
+      auto const now = clock_type::now();
+      auto const d = now - ri.times_.written;
+
+      // Skips the commands that don't have a response e.g. SUBSCRIBE,
+      // for which has_response returns true.
+      auto const& payload = ri.req_->payload();
+      std::string_view cmd;
+      do {
+         cmd = next_command(payload, ri.times_.command_pos);
+      } while (!cmd.empty() && has_response(cmd));
+
+      if (!cmd.empty())
+         metrics_.record_command(cmd, d);
+
+      if (ri.expected_responses_ == 1)
+         metrics_.record_response(d);
+   }
+
    void reset()
    {
+      usage_.connections += 1;
       write_buffer_.clear();
+      write_buffers_.clear();
       read_buffer_.clear();
+      shrink_read_buffer();
+      read_buffer_.reserve(runner_.get_config().read_buffer_initial_capacity);
       parser_.reset();
       on_push_ = false;
+      drop_push_ = false;
+      direct_read_size_ = 0;
    }
 
    asio::ssl::context ctx_;
@@ -937,7 +1550,15 @@ private:
    // also more suitable than a channel and the notify operation does
    // not suspend.
    timer_type writer_timer_;
+
+   // Wakes up the reader when it waits for pushes to be received,
+   // see config::push_overflow.
+   timer_type push_timer_;
    receive_channel_type receive_channel_;
+   std::function<void()> consume_oldest_push_;
+   std::size_t pushes_pending_ = 0;
+   std::size_t push_bytes_pending_ = 0;
+   bool drop_push_ = false;
    runner_type runner_;
    receiver_adapter_type receive_adapter_;
 
@@ -946,11 +1567,41 @@ private:
    std::string read_buffer_;
    dyn_buffer_type dbuf_;
    std::string write_buffer_;
-   reqs_type reqs_;
+   std::vector<asio::const_buffer> write_buffers_;
+
+   // Requests are linked in one of the lists below according to
+   // their status, so that status transitions don't have to
+   // traverse the others.
+   req_list_type written_;
+   req_list_type staged_;
+   req_list_type waiting_;
+   std::vector<std::shared_ptr<req_info>> req_pool_;
+
+   // Deadlines of the requests with a timeout, see
+   // request::config::timeout. The timer is armed at the first one.
+   timer_wheel deadlines_{clock_type::now()};
+   timer_type deadline_timer_;
+   bool deadline_armed_ = false;
+   std::shared_ptr<this_type*> deadline_self_ = std::make_shared<this_type*>(this);
+
+   // Placeholders of the responses of timed out requests, see
+   // discard_response.
+   request discard_req_;
+   std::vector<std::shared_ptr<req_info>> discarded_;
+
    resp3::parser parser_{};
+   nodes_type nodes_;
    bool on_push_ = false;
 
+   // Size of the blob string being read directly into the response,
+   // see prepare_direct_read.
+   std::size_t direct_read_size_ = 0;
+   asio::mutable_buffer direct_read_buffer_;
+
    usage usage_;
+   Metrics metrics_;
+   Observer observer_;
+   std::uint64_t last_request_id_ = 0;
 };
 
 } // boost::redis::detail
@@ -12,6 +12,7 @@
 #include <boost/redis/response.hpp>
 #include <boost/redis/operation.hpp>
 #include <boost/redis/detail/helper.hpp>
+#include <boost/redis/detail/rtt.hpp>
 #include <boost/redis/config.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/compose.hpp>
@@ -43,13 +44,18 @@ public:
             return;
          }
 
-         BOOST_ASIO_CORO_YIELD
-         conn_->async_exec(checker_->req_, checker_->resp_, std::move(self));
-         if (ec || is_cancelled(self)) {
-            logger_.trace("ping_op: error/cancelled (1).");
-            checker_->wait_timer_.cancel();
-            self.complete(!!ec ? ec : asio::error::operation_aborted);
-            return;
+         if (checker_->must_ping(*conn_)) {
+            checker_->on_ping();
+            BOOST_ASIO_CORO_YIELD
+            conn_->async_exec(checker_->req_, checker_->resp_, std::move(self));
+            if (ec || is_cancelled(self)) {
+               logger_.trace("ping_op: error/cancelled (1).");
+               checker_->wait_timer_.cancel();
+               self.complete(!!ec ? ec : asio::error::operation_aborted);
+               return;
+            }
+
+            checker_->on_pong(*conn_);
          }
 
          // Wait before pinging again.
@@ -93,7 +99,7 @@ public:
             return;
          }
 
-         if (checker_->resp_.value().empty()) {
+         if (checker_->has_timed_out(*conn_)) {
             logger_.trace("check-timeout-op: Response has no value. Exiting ...");
             checker_->ping_timer_.cancel();
             conn_->cancel(operation::run);
@@ -102,7 +108,7 @@ public:
             return;
          }
 
-         if (checker_->resp_.has_value()) {
+         if (checker_->policy_ == health_check_policy::always && checker_->resp_.has_value()) {
             checker_->resp_.value().clear();
          }
       }
@@ -182,8 +188,18 @@ public:
       req_.clear();
       req_.push("PING", cfg.health_check_id);
       ping_interval_ = cfg.health_check_interval;
+      policy_ = cfg.health_check;
    }
 
+   auto get_pings() const noexcept
+      { return pings_; }
+
+   auto get_rtt() const noexcept
+      { return rtt_; }
+
+   auto get_srtt() const noexcept
+      { return srtt_.value(); }
+
    template <
       class Connection,
       class Logger,
@@ -196,6 +212,7 @@ public:
       CompletionToken token = CompletionToken{})
    {
       checker_has_exited_ = false;
+      ping_received_ = timeout_received_ = conn.get_received_messages();
       return asio::async_compose
          < CompletionToken
          , void(system::error_code)
@@ -235,6 +252,56 @@ private:
          >(check_timeout_op<health_checker, Connection, Logger>{this, &conn, l}, token, conn, wait_timer_);
    }
 
+   // With health_check_policy::idle the connection is pinged only
+   // if nothing but the previous PONG was received in the last
+   // interval.
+   template <class Connection>
+   bool must_ping(Connection const& conn) noexcept
+   {
+      if (policy_ == health_check_policy::always)
+         return true;
+
+      auto const n = conn.get_received_messages();
+      auto const ret = n == ping_received_;
+      ping_received_ = n;
+      return ret;
+   }
+
+   template <class Connection>
+   bool has_timed_out(Connection const& conn) noexcept
+   {
+      if (policy_ == health_check_policy::always)
+         return resp_.value().empty();
+
+      auto const n = conn.get_received_messages();
+      auto const ret = n == timeout_received_;
+      timeout_received_ = n;
+      return ret;
+   }
+
+   void on_ping() noexcept
+   {
+      ++pings_;
+      ping_time_ = std::chrono::steady_clock::now();
+   }
+
+   template <class Connection>
+   void on_pong(Connection const& conn)
+   {
+      rtt_ = std::chrono::steady_clock::now() - ping_time_;
+      srtt_.update(rtt_);
+
+      if (policy_ == health_check_policy::idle) {
+         // The PONG doesn't count as traffic for must_ping and,
+         // since has_timed_out doesn't look at it, is not kept.
+         ping_received_ = conn.get_received_messages();
+         if (resp_.has_value())
+            resp_.value().clear();
+         else
+            resp_ = generic_response{};
+      }
+   }
+
    template <class, class, class> friend class ping_op;
    template <class, class, class> friend class check_timeout_op;
    template <class, class, class> friend class check_health_op;
@@ -244,7 +311,18 @@ private:
    redis::request req_;
    redis::generic_response resp_;
    std::chrono::steady_clock::duration ping_interval_ = std::chrono::seconds{5};
+   health_check_policy policy_ = health_check_policy::always;
    bool checker_has_exited_ = false;
+
+   // Responses and pushes received by the connection when last
+   // checked, see must_ping and has_timed_out.
+   std::size_t ping_received_ = 0;
+   std::size_t timeout_received_ = 0;
+
+   std::size_t pings_ = 0;
+   std::chrono::steady_clock::time_point ping_time_;
+   std::chrono::steady_clock::duration rtt_{0};
+   smoothed_rtt srtt_;
 };
 
 } // boost::redis::detail
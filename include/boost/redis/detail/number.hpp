@@ -0,0 +1,91 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_DETAIL_NUMBER_HPP
+#define BOOST_REDIS_DETAIL_NUMBER_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace boost::redis::detail
+{
+
+// Decodes a decimal integer with an optional minus sign, as sent in
+// RESP length prefixes and numbers. Returns false if the string is
+// empty, contains anything else than digits or the value does not
+// fit in T. Unlike std::from_chars the whole string must be
+// consumed.
+//
+// Lengths and numbers are short, so up to 19 digits, which cannot
+// overflow a std::uint64_t, are accumulated in a loop whose only
+// branch is the loop condition. Longer strings are left to
+// std::from_chars.
+template <class T>
+auto parse_integer(T& out, std::string_view sv) noexcept -> bool
+{
+   static_assert(std::is_integral_v<T>);
+
+   auto const* p = sv.data();
+   auto const* const end = p + sv.size();
+
+   bool negative = false;
+   if constexpr (std::is_signed_v<T>) {
+      negative = p != end && *p == '-';
+      p += negative;
+   }
+
+   auto const digits = end - p;
+   if (digits == 0)
+      return false;
+
+   if (digits > 19) {
+      auto const res = std::from_chars(sv.data(), end, out);
+      return res.ec == std::errc() && res.ptr == end;
+   }
+
+   std::uint64_t n = 0;
+   bool invalid = false;
+   for (; p != end; ++p) {
+      auto const d = static_cast<unsigned char>(*p - '0');
+      invalid |= d > 9;
+      n = 10 * n + d;
+   }
+
+   if (invalid)
+      return false;
+
+   using limits = std::numeric_limits<T>;
+   std::uint64_t const max = negative
+      ? static_cast<std::uint64_t>(limits::max()) + 1
+      : static_cast<std::uint64_t>(limits::max());
+
+   if (n > max)
+      return false;
+
+   // Two's complement negation, well defined on unsigned.
+   out = static_cast<T>(negative ? 0 - n : n);
+   return true;
+}
+
+// Decodes a RESP3 double i.e. an optional sign, digits, an
+// optional fraction and exponent, or inf, -inf and nan. Returns false
+// if the string is not a double.
+//
+// Values with up to 19 significant digits whose mantissa and power of
+// ten are exactly representable, which covers what Redis sends, are
+// computed with a single multiplication or division and are thus
+// correctly rounded. Others fall back to std::from_chars or, on
+// standard libraries that lack it, to strtod on a stack buffer. The
+// latter only allocates for strings longer than 127 characters.
+auto parse_double(double& out, std::string_view sv) -> bool;
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_DETAIL_NUMBER_HPP
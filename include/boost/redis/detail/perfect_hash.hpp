@@ -0,0 +1,92 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_DETAIL_PERFECT_HASH_HPP
+#define BOOST_REDIS_DETAIL_PERFECT_HASH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace boost::redis::detail
+{
+
+// FNV-1a with the seed mixed into the offset basis.
+constexpr auto seeded_hash(std::string_view s, std::uint32_t seed) noexcept -> std::uint32_t
+{
+   std::uint32_t h = 2166136261u ^ (seed * 16777619u);
+   for (auto c: s) {
+      h ^= static_cast<unsigned char>(c);
+      h *= 16777619u;
+   }
+
+   return h;
+}
+
+// A perfect hash of N strings known at compile time, built by
+// searching for a seed under which no two strings fall in the same
+// slot. With about N * N / 2 slots a seed is found after a couple of
+// attempts on average, the table is therefore meant for small sets
+// e.g. the fields of a struct.
+template <std::size_t N>
+class perfect_hash {
+public:
+   // Returned by find when the string is not in the set.
+   static constexpr std::size_t npos = N;
+
+   constexpr explicit perfect_hash(std::array<std::string_view, N> const& keys)
+   : keys_{keys}
+   {
+      static_assert(N < 0xffff, "Too many keys.");
+
+      for (;; ++seed_) {
+         for (auto& slot: slots_)
+            slot = static_cast<std::uint16_t>(N);
+
+         bool collision = false;
+         for (std::size_t i = 0; i < N && !collision; ++i) {
+            auto& slot = slots_[seeded_hash(keys_[i], seed_) & (size - 1)];
+            collision = slot != N;
+            slot = static_cast<std::uint16_t>(i);
+         }
+
+         if (!collision)
+            return;
+      }
+   }
+
+   // Returns the index of s in the keys passed to the constructor or
+   // npos.
+   constexpr auto find(std::string_view s) const noexcept -> std::size_t
+   {
+      std::size_t const i = slots_[seeded_hash(s, seed_) & (size - 1)];
+      return (i != N && keys_[i] == s) ? i : npos;
+   }
+
+   constexpr auto get_seed() const noexcept
+      { return seed_; }
+
+private:
+   static constexpr auto slots_for(std::size_t n) noexcept -> std::size_t
+   {
+      std::size_t size = 1;
+      while (size < n * n / 2 + 1)
+         size *= 2;
+
+      return size;
+   }
+
+   static constexpr std::size_t size = slots_for(N);
+
+   std::array<std::string_view, N> keys_;
+   std::array<std::uint16_t, size> slots_{};
+   std::uint32_t seed_ = 0;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_DETAIL_PERFECT_HASH_HPP
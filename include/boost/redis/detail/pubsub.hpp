@@ -0,0 +1,120 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_DETAIL_PUBSUB_HPP
+#define BOOST_REDIS_DETAIL_PUBSUB_HPP
+
+#include <boost/redis/pubsub_message.hpp>
+#include <boost/redis/resp3/node.hpp>
+#include <boost/redis/resp3/type.hpp>
+#include <boost/redis/adapter/adapt.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+// Messages parsed from server pushes. Elements past size are kept
+// to reuse the capacity of their strings, so that no allocations
+// happen in steady state. Pushes other than messages e.g.
+// subscription confirmations are skipped.
+struct pubsub_queue {
+   std::vector<pubsub_message> messages;
+   std::size_t size = 0;
+
+   // Parser state of the current push.
+   std::size_t index = 0;
+   std::size_t expected = 0;
+   bool is_message = false;
+
+   void clear() noexcept
+      { size = 0; }
+};
+
+class pubsub_adapter {
+public:
+   explicit pubsub_adapter(pubsub_queue* q) : q_{q} {}
+
+   template <class String>
+   void operator()(std::size_t, resp3::basic_node<String> const& nd, system::error_code&)
+   {
+      if (nd.depth == 0) {
+         q_->index = 0;
+         q_->expected = nd.data_type == resp3::type::push ? nd.aggregate_size : 0;
+         q_->is_message = false;
+         return;
+      }
+
+      if (nd.depth != 1 || q_->expected <= q_->index)
+         return;
+
+      std::string_view const value{std::data(nd.value), std::size(nd.value)};
+      if (q_->index == 0) {
+         on_kind(value);
+      } else if (q_->is_message) {
+         auto& msg = q_->messages[q_->size];
+         std::size_t const offset = msg.kind == pubsub_kind::pmessage ? 1u : 0u;
+         if (q_->index == 1 && offset == 1u)
+            msg.pattern.assign(value);
+         else if (q_->index == 1 + offset)
+            msg.channel.assign(value);
+         else if (q_->index == 2 + offset)
+            msg.payload.assign(value);
+      }
+
+      if (++q_->index == q_->expected && q_->is_message)
+         ++q_->size;
+   }
+
+   [[nodiscard]]
+   auto get_supported_response_size() const noexcept
+      { return static_cast<std::size_t>(-1);}
+
+private:
+   void on_kind(std::string_view value)
+   {
+      auto kind = pubsub_kind::message;
+      if (value == "message" && q_->expected == 3)
+         kind = pubsub_kind::message;
+      else if (value == "pmessage" && q_->expected == 4)
+         kind = pubsub_kind::pmessage;
+      else if (value == "smessage" && q_->expected == 3)
+         kind = pubsub_kind::smessage;
+      else
+         return;
+
+      if (std::size(q_->messages) == q_->size)
+         q_->messages.emplace_back();
+
+      auto& msg = q_->messages[q_->size];
+      msg.kind = kind;
+      msg.pattern.clear();
+      q_->is_message = true;
+   }
+
+   pubsub_queue* q_;
+};
+
+} // boost::redis::detail
+
+namespace boost::redis::adapter::detail
+{
+
+template <>
+struct response_traits<redis::detail::pubsub_queue> {
+   using response_type = redis::detail::pubsub_queue;
+   using adapter_type = redis::detail::pubsub_adapter;
+
+   static auto adapt(response_type& q) noexcept
+      { return adapter_type{&q}; }
+};
+
+} // boost::redis::adapter::detail
+
+#endif // BOOST_REDIS_DETAIL_PUBSUB_HPP
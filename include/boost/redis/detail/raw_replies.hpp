@@ -0,0 +1,90 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_DETAIL_RAW_REPLIES_HPP
+#define BOOST_REDIS_DETAIL_RAW_REPLIES_HPP
+
+#include <boost/redis/resp3/node.hpp>
+#include <boost/redis/adapter/adapt.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+// The nodes of each reply to a request indexed by their position in
+// the request. Unlike generic_response errors are stored like any
+// other node, so each reply can be inspected, stored or forwarded to
+// another response on its own.
+struct raw_replies {
+   std::vector<std::vector<resp3::node>> values;
+};
+
+class raw_replies_adapter {
+public:
+   explicit raw_replies_adapter(raw_replies* r) : r_{r} {}
+
+   template <class String>
+   void operator()(std::size_t i, resp3::basic_node<String> const& nd, system::error_code&)
+   {
+      if (std::size(r_->values) <= i)
+         r_->values.resize(i + 1);
+
+      r_->values[i].push_back({nd.data_type, nd.aggregate_size, nd.depth, std::string{std::cbegin(nd.value), std::cend(nd.value)}});
+   }
+
+   [[nodiscard]]
+   auto get_supported_response_size() const noexcept
+      { return static_cast<std::size_t>(-1);}
+
+   auto get_bulk_destination(std::size_t) noexcept -> std::string*
+      { return nullptr; }
+
+private:
+   raw_replies* r_;
+};
+
+// Passes the replies to the response as if they had been read from
+// the socket.
+template <class Response>
+void
+deliver_replies(
+   std::vector<std::vector<resp3::node>> const& replies,
+   Response& resp,
+   system::error_code& ec)
+{
+   using namespace boost::redis::adapter;
+   auto f = boost_redis_adapt(resp);
+   for (std::size_t i = 0; i < std::size(replies); ++i) {
+      for (auto const& nd: replies[i]) {
+         f(i, resp3::basic_node<std::string_view>{nd.data_type, nd.aggregate_size, nd.depth, nd.value}, ec);
+         if (ec)
+            return;
+      }
+   }
+}
+
+} // boost::redis::detail
+
+namespace boost::redis::adapter::detail
+{
+
+template <>
+struct response_traits<redis::detail::raw_replies> {
+   using response_type = redis::detail::raw_replies;
+   using adapter_type = redis::detail::raw_replies_adapter;
+
+   static auto adapt(response_type& r) noexcept
+      { return adapter_type{&r}; }
+};
+
+} // boost::redis::adapter::detail
+
+#endif // BOOST_REDIS_DETAIL_RAW_REPLIES_HPP
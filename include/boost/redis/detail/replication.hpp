@@ -0,0 +1,49 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_DETAIL_REPLICATION_HPP
+#define BOOST_REDIS_DETAIL_REPLICATION_HPP
+
+#include <boost/redis/config.hpp>
+#include <boost/redis/request.hpp>
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+// Returns true if the command only reads data and can therefore be
+// sent to a replica.
+auto is_read_only_command(std::string_view cmd) noexcept -> bool;
+
+// Returns true if the request is not empty and all its commands are
+// read-only.
+auto is_read_only(request const& req) noexcept -> bool;
+
+// A replica as reported by INFO replication on the primary.
+struct replica_info {
+   address addr;
+   bool online = false;
+   std::size_t offset = 0;
+   std::size_t lag = 0;
+};
+
+// Parses the output of INFO replication e.g.
+//
+//    master_repl_offset:1234
+//    slave0:ip=127.0.0.1,port=6380,state=online,offset=1234,lag=0
+//
+void
+parse_info_replication(
+   std::string_view info,
+   std::size_t& primary_offset,
+   std::vector<replica_info>& replicas);
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_DETAIL_REPLICATION_HPP
@@ -0,0 +1,83 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_DETAIL_RING_BUFFER_HPP
+#define BOOST_REDIS_DETAIL_RING_BUFFER_HPP
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace boost::redis::detail
+{
+
+// A FIFO queue over a circular buffer that grows geometrically.
+// Removed elements are not destroyed but kept in the buffer, so
+// that e.g. the memory held by strings is reused when the slot is
+// handed out again by push_back. Callers must therefore assign all
+// members of the slot returned by push_back.
+template <class T>
+class ring_buffer {
+public:
+   // Returns the slot past the last element.
+   auto push_back() -> T&
+   {
+      if (size_ == std::size(buffer_))
+         grow();
+
+      ++size_;
+      return back();
+   }
+
+   void pop_front(std::size_t n = 1) noexcept
+   {
+      BOOST_ASSERT(n <= size_);
+      head_ = (head_ + n) % (std::max)(std::size(buffer_), std::size_t{1});
+      size_ -= n;
+   }
+
+   void clear() noexcept
+   {
+      head_ = 0;
+      size_ = 0;
+   }
+
+   auto operator[](std::size_t i) noexcept -> T&
+      { return buffer_[(head_ + i) % std::size(buffer_)]; }
+
+   auto operator[](std::size_t i) const noexcept -> T const&
+      { return buffer_[(head_ + i) % std::size(buffer_)]; }
+
+   auto front() noexcept -> T& { return (*this)[0]; }
+   auto front() const noexcept -> T const& { return (*this)[0]; }
+   auto back() noexcept -> T& { return (*this)[size_ - 1]; }
+   auto back() const noexcept -> T const& { return (*this)[size_ - 1]; }
+
+   auto size() const noexcept { return size_; }
+   auto empty() const noexcept { return size_ == 0; }
+   auto capacity() const noexcept { return std::size(buffer_); }
+
+private:
+   void grow()
+   {
+      // Linearizes the elements so that the new slots come after the
+      // last one.
+      std::rotate(std::begin(buffer_), std::next(std::begin(buffer_), head_), std::end(buffer_));
+      head_ = 0;
+      buffer_.resize((std::max)(2 * std::size(buffer_), std::size_t{8}));
+   }
+
+   std::vector<T> buffer_;
+   std::size_t head_ = 0;
+   std::size_t size_ = 0;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_DETAIL_RING_BUFFER_HPP
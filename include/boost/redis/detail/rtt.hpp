@@ -0,0 +1,39 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_DETAIL_RTT_HPP
+#define BOOST_REDIS_DETAIL_RTT_HPP
+
+#include <chrono>
+
+namespace boost::redis::detail
+{
+
+// Smoothed round-trip time, an exponential moving average with
+// weight 1/8 like TCP's SRTT. The first sample is taken as is. Used
+// by the health checker and by replicated_connection so that both
+// report comparable values.
+class smoothed_rtt {
+public:
+   using duration = std::chrono::steady_clock::duration;
+
+   void update(duration rtt) noexcept
+   {
+      value_ = sampled_ ? value_ + (rtt - value_) / 8 : rtt;
+      sampled_ = true;
+   }
+
+   auto value() const noexcept
+      { return value_; }
+
+private:
+   duration value_{0};
+   bool sampled_ = false;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_DETAIL_RTT_HPP
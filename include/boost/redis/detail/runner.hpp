@@ -26,6 +26,7 @@
 #include <string>
 #include <memory>
 #include <chrono>
+#include <vector>
 
 namespace boost::redis::detail
 {
@@ -201,6 +202,9 @@ public:
 
    config const& get_config() const noexcept {return cfg_;}
 
+   auto const& get_health_checker() const noexcept
+      { return health_checker_; }
+
 private:
    using resolver_type = resolver<Executor>;
    using connector_type = connector<Executor>;
@@ -243,6 +247,19 @@ private:
 
       if (cfg_.database_index && cfg_.database_index.value() != 0)
          hello_req_.push("SELECT", cfg_.database_index.value());
+
+      if (cfg_.tracking != client_tracking::off) {
+         std::vector<std::string> args{"TRACKING", "ON"};
+         if (cfg_.tracking == client_tracking::bcast) {
+            args.push_back("BCAST");
+            for (auto const& prefix: cfg_.tracking_prefixes) {
+               args.push_back("PREFIX");
+               args.push_back(prefix);
+            }
+         }
+
+         hello_req_.push_range("CLIENT", args);
+      }
    }
 
    bool has_error_in_response() const noexcept
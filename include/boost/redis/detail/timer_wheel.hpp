@@ -0,0 +1,129 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_DETAIL_TIMER_WHEEL_HPP
+#define BOOST_REDIS_DETAIL_TIMER_WHEEL_HPP
+
+#include <boost/intrusive/list.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace boost::redis::detail
+{
+
+class timer_wheel;
+
+// An element of a timer_wheel, meant to be used as a base class.
+class timer_wheel_node {
+public:
+   [[nodiscard]] auto is_scheduled() const noexcept
+      { return hook_.is_linked(); }
+
+private:
+   friend class timer_wheel;
+
+   using hook_type = intrusive::list_member_hook<intrusive::link_mode<intrusive::auto_unlink>>;
+
+   hook_type hook_;
+
+   // The tick at which the node expires.
+   std::uint64_t tick_ = 0;
+};
+
+// A hierarchical timing wheel, see Varghese and Lauck, Hashed and
+// hierarchical timing wheels. Scheduling and cancelling are O(1),
+// which allows a connection to keep a deadline per request with a
+// single asio timer that is armed at next_expiry.
+//
+// Level 0 has a slot per tick for the next 64 ticks, each level
+// above covers 64 times more ticks per slot. Nodes are moved to a
+// lower level when the wheel reaches their slot. With the default
+// resolution of one millisecond the four levels cover about four
+// hours, later deadlines are parked at the top level until they
+// come in range.
+class timer_wheel {
+public:
+   using clock_type = std::chrono::steady_clock;
+
+   static constexpr std::size_t slot_bits = 6;
+   static constexpr std::size_t slots = 1 << slot_bits;
+   static constexpr std::size_t levels = 4;
+
+   explicit
+   timer_wheel(
+      clock_type::time_point origin,
+      clock_type::duration resolution = std::chrono::milliseconds{1});
+
+   // Schedules the node to expire at the first tick at or after the
+   // deadline, but never at the current tick. The node must not be
+   // scheduled.
+   void schedule(timer_wheel_node& node, clock_type::time_point deadline) noexcept;
+
+   // Removes the node from the wheel if it is scheduled.
+   void cancel(timer_wheel_node& node) noexcept;
+
+   // Advances the wheel to now and calls f(node) for every expired
+   // node, in order of expiry. Nodes are removed from the wheel
+   // before f is called, which can schedule them again.
+   template <class F>
+   void advance(clock_type::time_point now, F f)
+   {
+      auto const target = to_tick(now);
+      if (size_ == 0 && current_ < target)
+         current_ = target;
+
+      while (current_ < target) {
+         ++current_;
+         cascade();
+
+         auto& slot = wheel_[0][current_ % slots];
+         while (!slot.empty()) {
+            auto& node = slot.front();
+            slot.pop_front();
+            --size_;
+            f(node);
+         }
+      }
+   }
+
+   // Returns the time at which advance should be called next, at the
+   // latest, or time_point::max() if the wheel is empty.
+   auto next_expiry() const noexcept -> clock_type::time_point;
+
+   [[nodiscard]] auto size() const noexcept { return size_; }
+   [[nodiscard]] auto empty() const noexcept { return size_ == 0; }
+   [[nodiscard]] auto get_resolution() const noexcept { return resolution_; }
+
+private:
+   using list_type =
+      intrusive::list<
+         timer_wheel_node,
+         intrusive::member_hook<timer_wheel_node, timer_wheel_node::hook_type, &timer_wheel_node::hook_>,
+         intrusive::constant_time_size<false>>;
+
+   // Returns the last tick that is not after t.
+   auto to_tick(clock_type::time_point t) const noexcept -> std::uint64_t;
+
+   // Links the node in the slot of its tick.
+   void place(timer_wheel_node& node) noexcept;
+
+   // Moves the nodes in the slots that start at the current tick to
+   // the levels below.
+   void cascade() noexcept;
+
+   clock_type::time_point origin_;
+   clock_type::duration resolution_;
+   std::uint64_t current_ = 0;
+   std::size_t size_ = 0;
+   std::array<std::array<list_type, slots>, levels> wheel_;
+};
+
+} // boost::redis::detail
+
+#endif // BOOST_REDIS_DETAIL_TIMER_WHEEL_HPP
@@ -81,6 +81,12 @@ enum class error
 
    /// Incompatible node depth.
    incompatible_node_depth,
+
+   /// Invalid response to CLUSTER SLOTS.
+   invalid_cluster_slots,
+
+   /// Request timeout, see `request::config::timeout`.
+   request_timeout,
 };
 
 /** \internal
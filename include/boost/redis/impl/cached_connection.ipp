@@ -0,0 +1,193 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/cached_connection.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace boost::redis {
+namespace detail
+{
+
+// Commands whose reply depends only on the value of the key passed
+// as first argument, sorted for binary search. Commands that depend
+// on time, e.g. TTL, or are random, e.g. SRANDMEMBER, are excluded.
+constexpr std::string_view cacheable_commands[] =
+{ "BITCOUNT", "BITPOS", "EXISTS", "GEODIST", "GEOHASH", "GEOPOS", "GET"
+, "GETBIT", "GETRANGE", "HEXISTS", "HGET", "HGETALL", "HKEYS", "HLEN"
+, "HMGET", "HSTRLEN", "HVALS", "LINDEX", "LLEN", "LPOS", "LRANGE"
+, "SCARD", "SISMEMBER", "SMEMBERS", "SMISMEMBER", "STRLEN", "TYPE"
+, "XLEN", "XRANGE", "XREVRANGE", "ZCARD", "ZCOUNT", "ZLEXCOUNT"
+, "ZMSCORE", "ZRANGE", "ZRANGEBYLEX", "ZRANGEBYSCORE", "ZRANK"
+, "ZREVRANGE", "ZREVRANGEBYLEX", "ZREVRANGEBYSCORE", "ZREVRANK"
+, "ZSCORE"
+};
+
+auto is_cacheable_command(std::string_view cmd) noexcept -> bool
+{
+   auto const up = [](char c) { return ('a' <= c && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c; };
+   auto const less = [&](std::string_view a, std::string_view b)
+   {
+      return std::lexicographical_compare(
+         std::cbegin(a), std::cend(a), std::cbegin(b), std::cend(b),
+         [&](char x, char y) { return up(x) < up(y); });
+   };
+
+   auto const pos = std::lower_bound(std::cbegin(cacheable_commands), std::cend(cacheable_commands), cmd, less);
+   return pos != std::cend(cacheable_commands) && !less(cmd, *pos);
+}
+
+} // detail
+
+cached_connection::cached_connection(
+   executor_type ex,
+   std::size_t cache_capacity,
+   asio::ssl::context::method method,
+   std::size_t max_read_size)
+: conn_{ex, method, max_read_size}
+, cache_{cache_capacity}
+{
+   conn_.set_receive_response(push_resp_);
+}
+
+void cached_connection::start_run(config const& cfg, logger l)
+{
+   cfg_ = cfg;
+   if (cfg_.tracking == client_tracking::off)
+      cfg_.tracking = client_tracking::on;
+
+   logger_ = l;
+}
+
+void cached_connection::run_connection()
+{
+   // Stops the invalidation loop when the connection is not
+   // reconnecting anymore.
+   conn_.async_run(cfg_, logger_, [this](system::error_code) {
+      conn_.cancel(operation::receive);
+   });
+}
+
+void cached_connection::check_connections()
+{
+   // Invalidation messages might have been lost while disconnected.
+   auto const n = conn_.get_usage().connections;
+   if (n != connections_) {
+      connections_ = n;
+      cache_.clear();
+   }
+}
+
+void cached_connection::on_push()
+{
+   check_connections();
+
+   // Invalidation messages have the form
+   //
+   //    >2
+   //    $10 invalidate
+   //    *N key1 ... keyN
+   //
+   // where the array of keys is null when the database has been
+   // flushed.
+   if (push_resp_.has_value()) {
+      auto const& nodes = push_resp_.value();
+      if (std::size(nodes) >= 3 && nodes[1].value == "invalidate") {
+         if (nodes[2].data_type == resp3::type::null) {
+            cache_.clear();
+         } else {
+            for (auto i = std::next(std::cbegin(nodes), 3); i != std::cend(nodes); ++i) {
+               if (i->depth == 2)
+                  cache_.invalidate(i->value);
+            }
+         }
+      }
+   }
+
+   push_resp_ = generic_response{};
+}
+
+auto cached_connection::is_tracked(std::string_view key) const noexcept -> bool
+{
+   // In broadcasting mode the server sends invalidation messages only
+   // for keys that match the prefixes.
+   if (cfg_.tracking != client_tracking::bcast || cfg_.tracking_prefixes.empty())
+      return true;
+
+   auto const match = [&](auto const& prefix) { return key.substr(0, std::size(prefix)) == prefix; };
+   return std::any_of(std::cbegin(cfg_.tracking_prefixes), std::cend(cfg_.tracking_prefixes), match);
+}
+
+void
+cached_connection::lookup(
+   request const& req,
+   detail::cached_exec_state& st,
+   system::error_code& ec)
+{
+   check_connections();
+
+   detail::parse_commands(req.payload(), st.cmds, ec);
+   if (ec)
+      return;
+
+   auto const n = std::size(st.cmds);
+   st.keys.assign(n, std::nullopt);
+   st.epochs.assign(n, 0);
+   st.hit = n != 0;
+
+   // Replies to commands in a transaction are QUEUED.
+   auto const is_multi = [](auto const& cmd) { return detail::iequals(cmd.name, "MULTI"); };
+   if (std::any_of(std::cbegin(st.cmds), std::cend(st.cmds), is_multi)) {
+      st.hit = false;
+      return;
+   }
+
+   for (std::size_t i = 0; i < n; ++i) {
+      auto const& cmd = st.cmds[i];
+      if (!detail::has_response(cmd.name) && !cmd.args.empty() && detail::is_cacheable_command(cmd.name) && is_tracked(cmd.args.front())) {
+         st.keys[i] = cmd.args.front();
+         st.epochs[i] = cache_.get_epoch(cmd.args.front());
+      } else {
+         st.hit = false;
+      }
+   }
+
+   st.cached.clear();
+   for (std::size_t i = 0; i < n && st.hit; ++i) {
+      st.cached.emplace_back();
+      st.hit = cache_.get(*st.keys[i], st.cmds[i].payload, st.cached.back());
+   }
+
+   st.connections = conn_.get_usage().connections;
+}
+
+void cached_connection::store(detail::cached_exec_state& st)
+{
+   // Tracking has only been enabled for keys read on the current
+   // connection.
+   if (conn_.get_usage().connections != st.connections)
+      return;
+
+   std::size_t index = 0;
+   for (std::size_t i = 0; i < std::size(st.cmds); ++i) {
+      if (detail::has_response(st.cmds[i].name))
+         continue;
+
+      if (st.keys[i] && index < std::size(st.replies.values)) {
+         auto& reply = st.replies.values[index];
+         auto const is_error = [](auto const& nd)
+            { return nd.data_type == resp3::type::simple_error || nd.data_type == resp3::type::blob_error; };
+
+         if (!reply.empty() && !is_error(reply.front()))
+            cache_.put(*st.keys[i], st.cmds[i].payload, reply, st.epochs[i]);
+      }
+
+      ++index;
+   }
+}
+
+} // boost::redis
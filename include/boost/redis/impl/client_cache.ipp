@@ -0,0 +1,138 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/client_cache.hpp>
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+namespace boost::redis {
+
+client_cache::client_cache(std::size_t capacity, std::size_t shards)
+{
+   BOOST_ASSERT_MSG(shards != 0, "The cache needs at least one shard.");
+
+   shard_capacity_ = (std::max)(capacity / shards, std::size_t{1});
+   shards_.reserve(shards);
+   for (std::size_t i = 0; i < shards; ++i)
+      shards_.push_back(std::make_unique<shard>());
+}
+
+auto client_cache::get_shard(std::string_view key) -> shard&
+{
+   return *shards_[std::hash<std::string_view>{}(key) % std::size(shards_)];
+}
+
+void client_cache::erase(shard& s, list_type::iterator it)
+{
+   s.by_cmd.erase(it->cmd);
+
+   auto const pos = s.by_key.find(it->key);
+   BOOST_ASSERT(pos != std::end(s.by_key));
+   auto& entries = pos->second;
+   entries.erase(std::find(std::begin(entries), std::end(entries), it));
+   if (entries.empty())
+      s.by_key.erase(pos);
+
+   s.lru.erase(it);
+}
+
+bool client_cache::get(std::string_view key, std::string_view cmd, reply_type& reply)
+{
+   auto& s = get_shard(key);
+   std::lock_guard<std::mutex> lock{s.mutex};
+
+   auto const pos = s.by_cmd.find(cmd);
+   if (pos == std::end(s.by_cmd)) {
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+   }
+
+   s.lru.splice(std::begin(s.lru), s.lru, pos->second);
+   reply = pos->second->reply;
+   hits_.fetch_add(1, std::memory_order_relaxed);
+   return true;
+}
+
+auto client_cache::get_epoch(std::string_view key) -> std::size_t
+{
+   auto& s = get_shard(key);
+   std::lock_guard<std::mutex> lock{s.mutex};
+   return s.epoch;
+}
+
+bool client_cache::put(std::string_view key, std::string_view cmd, reply_type reply, std::size_t epoch)
+{
+   auto& s = get_shard(key);
+   std::lock_guard<std::mutex> lock{s.mutex};
+
+   if (s.epoch != epoch)
+      return false;
+
+   auto const pos = s.by_cmd.find(cmd);
+   if (pos != std::end(s.by_cmd)) {
+      pos->second->reply = std::move(reply);
+      s.lru.splice(std::begin(s.lru), s.lru, pos->second);
+      return true;
+   }
+
+   if (std::size(s.lru) >= shard_capacity_)
+      erase(s, std::prev(std::end(s.lru)));
+
+   s.lru.push_front({std::string{key}, std::string{cmd}, std::move(reply)});
+   auto const it = std::begin(s.lru);
+   s.by_cmd.emplace(it->cmd, it);
+   s.by_key[it->key].push_back(it);
+   return true;
+}
+
+void client_cache::invalidate(std::string_view key)
+{
+   auto& s = get_shard(key);
+   std::lock_guard<std::mutex> lock{s.mutex};
+
+   invalidations_.fetch_add(1, std::memory_order_relaxed);
+   ++s.epoch;
+
+   auto const pos = s.by_key.find(std::string{key});
+   if (pos == std::end(s.by_key))
+      return;
+
+   for (auto it: pos->second) {
+      s.by_cmd.erase(it->cmd);
+      s.lru.erase(it);
+   }
+
+   s.by_key.erase(pos);
+}
+
+void client_cache::clear()
+{
+   invalidations_.fetch_add(1, std::memory_order_relaxed);
+
+   for (auto& s: shards_) {
+      std::lock_guard<std::mutex> lock{s->mutex};
+      ++s->epoch;
+      s->by_cmd.clear();
+      s->by_key.clear();
+      s->lru.clear();
+   }
+}
+
+auto client_cache::size() const -> std::size_t
+{
+   std::size_t ret = 0;
+   for (auto const& s: shards_) {
+      std::lock_guard<std::mutex> lock{s->mutex};
+      ret += std::size(s->lru);
+   }
+
+   return ret;
+}
+
+} // boost::redis
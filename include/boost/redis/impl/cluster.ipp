@@ -0,0 +1,456 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/cluster.hpp>
+#include <boost/redis/resp3/parser.hpp>
+#include <boost/redis/error.hpp>
+
+#include <array>
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+
+namespace boost::redis::detail
+{
+
+constexpr auto make_crc16_table() noexcept
+{
+   std::array<std::uint16_t, 256> table{};
+   for (std::size_t i = 0; i < table.size(); ++i) {
+      auto crc = static_cast<std::uint16_t>(i << 8);
+      for (int j = 0; j < 8; ++j)
+         crc = (crc & 0x8000) ? static_cast<std::uint16_t>((crc << 1) ^ 0x1021) : static_cast<std::uint16_t>(crc << 1);
+      table[i] = crc;
+   }
+
+   return table;
+}
+
+constexpr auto crc16_table = make_crc16_table();
+
+// Commands whose first argument is not a key. They are sent to any
+// node.
+constexpr std::string_view keyless_commands[] =
+{ "ASKING", "AUTH", "BGREWRITEAOF", "BGSAVE", "CLIENT", "CLUSTER"
+, "COMMAND", "CONFIG", "DBSIZE", "DEBUG", "DISCARD", "ECHO", "EXEC"
+, "FLUSHALL", "FLUSHDB", "FUNCTION", "HELLO", "INFO", "KEYS"
+, "LASTSAVE", "LATENCY", "MEMORY", "MULTI", "PING", "PSUBSCRIBE"
+, "PUBLISH", "PUNSUBSCRIBE", "QUIT", "RANDOMKEY", "READONLY"
+, "READWRITE", "RESET", "ROLE", "SAVE", "SCAN", "SCRIPT", "SELECT"
+, "SLOWLOG", "SUBSCRIBE", "SWAPDB", "TIME", "UNSUBSCRIBE", "WAIT"
+};
+
+auto to_number(std::string_view s, std::size_t& n) noexcept -> bool
+{
+   auto const res = std::from_chars(s.data(), s.data() + s.size(), n);
+   return res.ec == std::errc{} && res.ptr == s.data() + s.size();
+}
+
+auto crc16(std::string_view data) noexcept -> std::uint16_t
+{
+   std::uint16_t crc = 0;
+   for (auto c: data)
+      crc = static_cast<std::uint16_t>((crc << 8) ^ crc16_table[((crc >> 8) ^ static_cast<unsigned char>(c)) & 0xff]);
+
+   return crc;
+}
+
+auto get_hash_slot(std::string_view key) noexcept -> std::size_t
+{
+   // Only the part between the first { and the next } is hashed if
+   // it is not empty.
+   auto const open = key.find('{');
+   if (open != std::string_view::npos) {
+      auto const close = key.find('}', open + 1);
+      if (close != std::string_view::npos && close != open + 1)
+         key = key.substr(open + 1, close - open - 1);
+   }
+
+   return crc16(key) % cluster_slots;
+}
+
+void
+parse_commands(
+   std::string_view payload,
+   std::vector<cluster_command>& cmds,
+   system::error_code& ec)
+{
+   cmds.clear();
+   while (!payload.empty()) {
+      resp3::parser p;
+      cluster_command cmd;
+      while (!p.done()) {
+         auto const res = p.consume(payload, ec);
+         if (ec)
+            return;
+
+         if (!res) {
+            ec = error::incompatible_size;
+            return;
+         }
+
+         auto const& nd = res.value();
+         if (nd.depth == 0 && nd.data_type != resp3::type::array) {
+            ec = error::expects_resp3_aggregate;
+            return;
+         }
+
+         if (nd.depth != 1)
+            continue;
+
+         if (cmd.name.empty())
+            cmd.name = nd.value;
+         else
+            cmd.args.push_back(nd.value);
+      }
+
+      cmd.payload = payload.substr(0, p.get_consumed());
+      payload.remove_prefix(p.get_consumed());
+      cmds.push_back(std::move(cmd));
+   }
+}
+
+auto get_command_key(cluster_command const& cmd) -> std::optional<std::string_view>
+{
+   auto const is = [&](std::string_view name) { return iequals(cmd.name, name); };
+
+   for (auto name: keyless_commands) {
+      if (is(name))
+         return {};
+   }
+
+   if (is("EVAL") || is("EVALSHA") || is("EVAL_RO") || is("EVALSHA_RO") || is("FCALL") || is("FCALL_RO")) {
+      // script numkeys key [key ...] arg [arg ...]
+      std::size_t numkeys = 0;
+      if (std::size(cmd.args) < 3 || !to_number(cmd.args[1], numkeys) || numkeys == 0)
+         return {};
+
+      return cmd.args[2];
+   }
+
+   if (is("XREAD") || is("XREADGROUP")) {
+      // [...] STREAMS key [key ...] id [id ...]
+      auto const pos = std::find_if(std::cbegin(cmd.args), std::cend(cmd.args), [](auto arg) { return iequals(arg, "STREAMS"); });
+      if (pos == std::cend(cmd.args) || std::next(pos) == std::cend(cmd.args))
+         return {};
+
+      return *std::next(pos);
+   }
+
+   if (cmd.args.empty())
+      return {};
+
+   return cmd.args.front();
+}
+
+void
+make_units(
+   std::vector<cluster_command> const& cmds,
+   std::vector<cluster_unit>& units)
+{
+   units.clear();
+   auto const n = std::size(cmds);
+   for (std::size_t i = 0; i < n;) {
+      cluster_unit unit{i, i + 1, {}};
+      if (iequals(cmds[i].name, "MULTI")) {
+         // The transaction must be executed on a single node.
+         while (unit.last < n && !iequals(cmds[unit.last].name, "EXEC") && !iequals(cmds[unit.last].name, "DISCARD"))
+            ++unit.last;
+
+         if (unit.last < n)
+            ++unit.last;
+      }
+
+      for (auto j = unit.first; j < unit.last && !unit.slot; ++j) {
+         if (auto const key = get_command_key(cmds[j]))
+            unit.slot = get_hash_slot(*key);
+      }
+
+      units.push_back(unit);
+      i = unit.last;
+   }
+}
+
+void
+append_unit(
+   request& req,
+   std::vector<cluster_command> const& cmds,
+   cluster_unit const& unit)
+{
+   for (auto i = unit.first; i < unit.last; ++i) {
+      if (cmds[i].args.empty())
+         req.push(cmds[i].name);
+      else
+         req.push_range(cmds[i].name, cmds[i].args);
+   }
+}
+
+void
+parse_cluster_slots(
+   std::vector<resp3::node> const& nodes,
+   std::string_view default_host,
+   std::vector<cluster_slot_range>& ranges,
+   system::error_code& ec)
+{
+   // The response has the form
+   //
+   //    [[begin, end, [host, port, id, ...], [host, port, id, ...], ...], ...]
+   //
+   // where the first endpoint is the primary and the others are
+   // replicas.
+   ranges.clear();
+   if (nodes.empty() || nodes.front().data_type != resp3::type::array) {
+      ec = error::invalid_cluster_slots;
+      return;
+   }
+
+   std::size_t field = 0;
+   std::size_t endpoint = 0;
+   std::size_t endpoint_field = 0;
+   address addr;
+
+   for (auto i = std::next(std::cbegin(nodes)); i != std::cend(nodes); ++i) {
+      switch (i->depth) {
+         case 1:
+         {
+            if (i->data_type != resp3::type::array) {
+               ec = error::invalid_cluster_slots;
+               return;
+            }
+
+            ranges.push_back({});
+            field = 0;
+            endpoint = 0;
+         } break;
+         case 2:
+         {
+            auto& range = ranges.back();
+            if (field == 0 && !to_number(i->value, range.begin)) {
+               ec = error::invalid_cluster_slots;
+               return;
+            }
+
+            if (field == 1 && !to_number(i->value, range.end)) {
+               ec = error::invalid_cluster_slots;
+               return;
+            }
+
+            if (field >= 2) {
+               if (i->data_type != resp3::type::array) {
+                  ec = error::invalid_cluster_slots;
+                  return;
+               }
+
+               endpoint_field = 0;
+            }
+
+            ++field;
+         } break;
+         case 3:
+         {
+            // Fields after the port e.g. the node id are ignored.
+            if (endpoint_field == 0) {
+               addr.host = i->value.empty() ? std::string{default_host} : i->value;
+            } else if (endpoint_field == 1) {
+               addr.port = i->value;
+               auto& range = ranges.back();
+               if (endpoint == 0)
+                  range.primary = addr;
+               else
+                  range.replicas.push_back(addr);
+               ++endpoint;
+            }
+
+            ++endpoint_field;
+         } break;
+         default:;
+      }
+   }
+
+   for (auto const& range: ranges) {
+      if (range.begin > range.end || range.end >= cluster_slots || range.primary.port.empty()) {
+         ec = error::invalid_cluster_slots;
+         return;
+      }
+   }
+}
+
+auto
+parse_redirection(
+   std::string_view msg,
+   std::string_view default_host) -> std::optional<redirection>
+{
+   redirection ret;
+   if (msg.substr(0, 6) == "MOVED ") {
+      msg.remove_prefix(6);
+   } else if (msg.substr(0, 4) == "ASK ") {
+      ret.ask = true;
+      msg.remove_prefix(4);
+   } else {
+      return {};
+   }
+
+   auto const space = msg.find(' ');
+   if (space == std::string_view::npos || !to_number(msg.substr(0, space), ret.slot) || ret.slot >= cluster_slots)
+      return {};
+
+   // The host may be an IPv6 address, the port follows the last
+   // colon.
+   auto const endpoint = msg.substr(space + 1);
+   auto const colon = endpoint.rfind(':');
+   if (colon == std::string_view::npos || colon + 1 == std::size(endpoint))
+      return {};
+
+   ret.addr.host = colon == 0 ? std::string{default_host} : std::string{endpoint.substr(0, colon)};
+   ret.addr.port = std::string{endpoint.substr(colon + 1)};
+   return ret;
+}
+
+cluster_router::cluster_router()
+: nodes_(1)
+, slots_(cluster_slots, 0)
+{ }
+
+auto cluster_router::find_or_add_node(address const& addr) -> std::size_t
+{
+   auto const match = [&](auto const& a)
+      { return a.host == addr.host && a.port == addr.port; };
+
+   auto const pos = std::find_if(std::cbegin(nodes_), std::cend(nodes_), match);
+   if (pos != std::cend(nodes_))
+      return std::distance(std::cbegin(nodes_), pos);
+
+   nodes_.push_back(addr);
+   return std::size(nodes_) - 1;
+}
+
+void cluster_router::set_slots(std::vector<cluster_slot_range> const& ranges)
+{
+   for (auto const& range: ranges) {
+      auto const i = find_or_add_node(range.primary);
+      std::fill(std::begin(slots_) + range.begin, std::begin(slots_) + range.end + 1, i);
+   }
+}
+
+void
+cluster_router::init_exec(
+   request const& req,
+   cluster_exec_state& st,
+   system::error_code& ec) const
+{
+   parse_commands(req.payload(), st.cmds, ec);
+   if (ec)
+      return;
+
+   make_units(st.cmds, st.units);
+
+   std::size_t index = 0;
+   st.first_response.clear();
+   st.pending.clear();
+   for (std::size_t u = 0; u < std::size(st.units); ++u) {
+      st.first_response.push_back(index);
+      st.pending.push_back(u);
+      for (auto i = st.units[u].first; i < st.units[u].last; ++i) {
+         if (!has_response(st.cmds[i].name))
+            ++index;
+      }
+   }
+
+   st.redirections.assign(std::size(st.units), std::nullopt);
+   st.replies.assign(index, {});
+   st.size = 0;
+}
+
+void
+cluster_router::make_subrequests(
+   request const& req,
+   cluster_exec_state& st)
+{
+   st.subs.clear();
+   for (auto const u: st.pending) {
+      auto const& unit = st.units[u];
+      auto const& redir = st.redirections[u];
+
+      std::size_t i = 0;
+      if (redir)
+         i = find_or_add_node(redir->addr);
+      else if (unit.slot)
+         i = slots_[*unit.slot];
+
+      auto sub = std::find_if(std::begin(st.subs), std::end(st.subs), [i](auto const& s) { return s.node == i; });
+      if (sub == std::end(st.subs)) {
+         st.subs.push_back({i, request{req.get_config()}, {}, {}});
+         sub = std::prev(std::end(st.subs));
+      }
+
+      if (redir && redir->ask) {
+         sub->req.push("ASKING");
+         sub->origins.push_back({u, std::nullopt});
+      }
+
+      append_unit(sub->req, st.cmds, unit);
+
+      auto index = st.first_response[u];
+      for (auto j = unit.first; j < unit.last; ++j) {
+         if (!has_response(st.cmds[j].name))
+            sub->origins.push_back({u, index++});
+      }
+   }
+
+   st.pending.clear();
+}
+
+auto
+cluster_router::on_subrequests(
+   cluster_exec_state& st,
+   bool follow_redirections) -> bool
+{
+   bool moved = false;
+
+   for (auto const& sub: st.subs) {
+      for (auto const& origin: sub.origins)
+         st.redirections[origin.unit].reset();
+   }
+
+   // A unit is sent again when any of its responses is a
+   // redirection e.g. a command inside a transaction.
+   if (follow_redirections) {
+      for (auto const& sub: st.subs) {
+         auto const n = (std::min)(std::size(sub.origins), std::size(sub.replies.values));
+         for (std::size_t i = 0; i < n; ++i) {
+            auto const& origin = sub.origins[i];
+            auto const& nodes = sub.replies.values[i];
+            if (!origin.index || st.redirections[origin.unit] || nodes.empty() || nodes.front().data_type != resp3::type::simple_error)
+               continue;
+
+            auto const redir = parse_redirection(nodes.front().value, nodes_[sub.node].host);
+            if (!redir)
+               continue;
+
+            if (!redir->ask) {
+               slots_[redir->slot] = find_or_add_node(redir->addr);
+               moved = true;
+            }
+
+            st.redirections[origin.unit] = redir;
+            st.pending.push_back(origin.unit);
+         }
+      }
+   }
+
+   for (auto& sub: st.subs) {
+      auto const n = (std::min)(std::size(sub.origins), std::size(sub.replies.values));
+      for (std::size_t i = 0; i < n; ++i) {
+         auto const& origin = sub.origins[i];
+         if (origin.index && !st.redirections[origin.unit])
+            st.replies[*origin.index] = std::move(sub.replies.values[i]);
+      }
+   }
+
+   return moved;
+}
+
+} // boost::redis::detail
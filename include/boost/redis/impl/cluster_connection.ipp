@@ -0,0 +1,134 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/cluster_connection.hpp>
+
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace boost::redis {
+
+cluster_connection::cluster_connection(
+   executor_type ex,
+   asio::ssl::context::method method,
+   std::size_t max_read_size)
+: ex_{ex}
+, method_{method}
+, max_read_size_{max_read_size}
+, timer_{ex}
+, slots_req_{request::config{true, false, true, false}}
+{
+   // The first node is the one passed in the config, commands are
+   // sent to it until the slot map is known.
+   nodes_.push_back(std::make_unique<node>(ex_, method_, max_read_size_));
+   slots_req_.push("CLUSTER", "SLOTS");
+}
+
+void cluster_connection::start_run(config const& cfg, logger l)
+{
+   cfg_ = cfg;
+   logger_ = l;
+   router_.set_seed(cfg.addr);
+   running_ = true;
+}
+
+void cluster_connection::run_node(std::size_t i)
+{
+   auto cfg = cfg_;
+   cfg.addr = router_.get_address(i);
+   nodes_[i]->conn.async_run(cfg, logger_, [](system::error_code) {});
+}
+
+void cluster_connection::add_nodes()
+{
+   while (std::size(nodes_) < router_.get_nodes()) {
+      nodes_.push_back(std::make_unique<node>(ex_, method_, max_read_size_));
+      if (running_)
+         run_node(std::size(nodes_) - 1);
+   }
+}
+
+void cluster_connection::prepare_refresh()
+{
+   refresh_pending_ = false;
+   slots_resp_ = generic_response{};
+}
+
+void cluster_connection::on_cluster_slots(system::error_code ec)
+{
+   if (ec) {
+      // Retries on the next node.
+      refresh_node_ = (refresh_node_ + 1) % std::size(nodes_);
+      timer_.expires_after(cfg_.reconnect_wait_interval);
+      return;
+   }
+
+   // An error response means the server has no cluster support,
+   // commands keep being sent to the node passed in the config.
+   if (slots_resp_.has_value()) {
+      std::vector<detail::cluster_slot_range> ranges;
+      detail::parse_cluster_slots(slots_resp_.value(), router_.get_address(refresh_node_).host, ranges, ec);
+      if (!ec) {
+         router_.set_slots(ranges);
+         add_nodes();
+      }
+   }
+
+   if (refresh_pending_)
+      timer_.expires_after(std::chrono::seconds::zero());
+   else
+      timer_.expires_at((std::chrono::steady_clock::time_point::max)());
+}
+
+void cluster_connection::request_refresh()
+{
+   refresh_pending_ = true;
+   timer_.cancel();
+}
+
+void
+cluster_connection::init_exec(
+   request const& req,
+   detail::cluster_exec_state& st,
+   system::error_code& ec)
+{
+   router_.init_exec(req, st, ec);
+}
+
+void
+cluster_connection::make_subrequests(
+   request const& req,
+   detail::cluster_exec_state& st)
+{
+   router_.make_subrequests(req, st);
+   add_nodes();
+}
+
+void
+cluster_connection::on_subrequests(
+   detail::cluster_exec_state& st,
+   bool follow_redirections)
+{
+   if (router_.on_subrequests(st, follow_redirections))
+      request_refresh();
+
+   add_nodes();
+}
+
+void cluster_connection::cancel(operation op)
+{
+   if (op == operation::run || op == operation::all) {
+      running_ = false;
+      timer_.cancel();
+   }
+
+   for (auto& nd: nodes_)
+      nd->conn.cancel(op);
+}
+
+} // boost::redis
@@ -0,0 +1,134 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection_pool.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/assert.hpp>
+
+#include <functional>
+#include <mutex>
+
+namespace boost::redis {
+namespace detail
+{
+
+// Completes the run operation of the pool when all connections are
+// done.
+class pool_run_state {
+public:
+   pool_run_state(
+      asio::any_io_executor ex,
+      asio::any_completion_handler<void(system::error_code)> handler,
+      std::size_t pending,
+      std::atomic<bool>& running)
+   : ex_{ex}
+   , handler_{std::move(handler)}
+   , pending_{pending}
+   , running_{running}
+   { }
+
+   void on_done(system::error_code const& ec)
+   {
+      std::unique_lock<std::mutex> lock{mutex_};
+      if (ec && !ec_)
+         ec_ = ec;
+
+      if (--pending_ != 0)
+         return;
+
+      lock.unlock();
+      running_.store(false);
+
+      auto ex = asio::get_associated_executor(handler_, ex_);
+      asio::post(ex, [h = std::move(handler_), ec = ec_]() mutable { std::move(h)(ec); });
+   }
+
+private:
+   asio::any_io_executor ex_;
+   asio::any_completion_handler<void(system::error_code)> handler_;
+   std::mutex mutex_;
+   std::size_t pending_;
+   std::atomic<bool>& running_;
+   system::error_code ec_;
+};
+
+} // detail
+
+connection_pool::connection_pool(
+   executor_type ex,
+   std::size_t size,
+   asio::ssl::context::method method,
+   std::size_t max_read_size)
+: ex_{ex}
+{
+   BOOST_ASSERT_MSG(size != 0, "The pool needs at least one connection.");
+
+   members_.reserve(size);
+   for (std::size_t i = 0; i < size; ++i)
+      members_.push_back(std::make_unique<detail::pool_member>(asio::make_strand(ex_), method, max_read_size));
+}
+
+auto connection_pool::select_least_loaded() noexcept -> std::size_t
+{
+   auto const start = next_.fetch_add(1, std::memory_order_relaxed);
+   auto const n = std::size(members_);
+
+   auto ret = start % n;
+   auto min = get_outstanding(ret);
+   for (std::size_t i = 1; i < n && min != 0; ++i) {
+      auto const j = (start + i) % n;
+      auto const outstanding = get_outstanding(j);
+      if (outstanding < min) {
+         min = outstanding;
+         ret = j;
+      }
+   }
+
+   return ret;
+}
+
+auto connection_pool::select_by_key(std::string_view key) const noexcept -> std::size_t
+{
+   return std::hash<std::string_view>{}(key) % std::size(members_);
+}
+
+void
+connection_pool::async_run_impl(
+   config const& cfg,
+   logger l,
+   asio::any_completion_handler<void(system::error_code)> token)
+{
+   // The connections read cfg_ while they run.
+   if (running_.exchange(true)) {
+      auto ex = asio::get_associated_executor(token, ex_);
+      asio::post(ex, [h = std::move(token)]() mutable { std::move(h)(asio::error::already_started); });
+      return;
+   }
+
+   cfg_ = cfg;
+   auto state = std::make_shared<detail::pool_run_state>(ex_, std::move(token), std::size(members_), running_);
+   for (auto& m: members_) {
+      auto* conn = &m->conn;
+      asio::dispatch(conn->get_executor(), [this, conn, l, state]() {
+         conn->async_run(cfg_, l, [state](system::error_code ec) {
+            state->on_done(ec);
+         });
+      });
+   }
+}
+
+void connection_pool::cancel(operation op)
+{
+   for (auto& m: members_) {
+      auto* conn = &m->conn;
+      asio::dispatch(conn->get_executor(), [conn, op]() {
+         conn->cancel(op);
+      });
+   }
+}
+
+} // boost::redis
@@ -6,16 +6,58 @@
 
 #include <boost/redis/logger.hpp>
 #include <boost/system/error_code.hpp>
-#include <iostream>
-#include <iterator>
+#include <charconv>
+#include <cstdio>
+
+namespace boost::redis::detail
+{
+
+void append_number(std::string& out, std::size_t n)
+{
+   char buffer[24];
+   auto const res = std::to_chars(buffer, buffer + sizeof buffer, n);
+   out.append(buffer, res.ptr);
+}
+
+// Error messages are formatted into a stack buffer, which does not
+// allocate unlike error_code::message().
+void append_error(std::string& out, system::error_code const& ec)
+{
+   char buffer[128];
+   out += ec.message(buffer, sizeof buffer);
+}
+
+void append_endpoint(std::string& out, asio::ip::tcp::endpoint const& ep)
+{
+   auto const addr = ep.address();
+   if (addr.is_v6()) {
+      out += '[';
+      out += addr.to_string();
+      out += ']';
+   } else {
+      out += addr.to_string();
+   }
+
+   out += ':';
+   append_number(out, ep.port());
+}
+
+} // boost::redis::detail
 
 namespace boost::redis
 {
 
-void logger::write_prefix()
+auto logger::begin_message() -> std::string&
+{
+   buffer_.clear();
+   buffer_ += prefix_;
+   return buffer_;
+}
+
+void logger::end_message()
 {
-   if (!std::empty(prefix_))
-      std::clog << prefix_;
+   buffer_ += '\n';
+   std::fwrite(buffer_.data(), 1, std::size(buffer_), stderr);
 }
 
 void logger::on_resolve(system::error_code const& ec, asio::ip::tcp::resolver::results_type const& res)
@@ -23,25 +65,22 @@ void logger::on_resolve(system::error_code const& ec, asio::ip::tcp::resolver::r
    if (level_ < level::info)
       return;
 
-   write_prefix();
+   auto& msg = begin_message();
 
-   std::clog << "run-all-op: resolve addresses ";
+   msg += "run-all-op: resolve addresses ";
 
    if (ec) {
-      std::clog << ec.message() << std::endl;
+      detail::append_error(msg, ec);
    } else {
-      auto begin = std::cbegin(res);
-      auto end = std::cend(res);
-
-      if (begin == end)
-         return;
-
-      std::clog << begin->endpoint();
-      for (auto iter = std::next(begin); iter != end; ++iter)
-         std::clog << ", " << iter->endpoint();
+      char const* sep = "";
+      for (auto const& e: res) {
+         msg += sep;
+         detail::append_endpoint(msg, e.endpoint());
+         sep = ", ";
+      }
    }
 
-   std::clog << std::endl;
+   end_message();
 }
 
 void logger::on_connect(system::error_code const& ec, asio::ip::tcp::endpoint const& ep)
@@ -49,16 +88,16 @@ void logger::on_connect(system::error_code const& ec, asio::ip::tcp::endpoint co
    if (level_ < level::info)
       return;
 
-   write_prefix();
+   auto& msg = begin_message();
 
-   std::clog << "run-all-op: connected to endpoint ";
+   msg += "run-all-op: connected to endpoint ";
 
    if (ec)
-      std::clog << ec.message() << std::endl;
+      detail::append_error(msg, ec);
    else
-      std::clog << ep;
+      detail::append_endpoint(msg, ep);
 
-   std::clog << std::endl;
+   end_message();
 }
 
 void logger::on_ssl_handshake(system::error_code const& ec)
@@ -66,9 +105,10 @@ void logger::on_ssl_handshake(system::error_code const& ec)
    if (level_ < level::info)
       return;
 
-   write_prefix();
-
-   std::clog << "Runner: SSL handshake " << ec.message() << std::endl;
+   auto& msg = begin_message();
+   msg += "Runner: SSL handshake ";
+   detail::append_error(msg, ec);
+   end_message();
 }
 
 void logger::on_connection_lost(system::error_code const& ec)
@@ -76,47 +116,36 @@ void logger::on_connection_lost(system::error_code const& ec)
    if (level_ < level::info)
       return;
 
-   write_prefix();
+   auto& msg = begin_message();
 
-   if (ec)
-      std::clog << "Connection lost: " << ec.message();
-   else
-      std::clog << "Connection lost.";
+   if (ec) {
+      msg += "Connection lost: ";
+      detail::append_error(msg, ec);
+   } else {
+      msg += "Connection lost.";
+   }
 
-   std::clog << std::endl;
+   end_message();
 }
 
 void
-logger::on_write(
+logger::write_io(
+   std::string_view op,
    system::error_code const& ec,
-   std::string const& payload)
+   std::size_t n,
+   std::string_view what)
 {
-   if (level_ < level::info)
-      return;
-
-   write_prefix();
-
-   if (ec)
-      std::clog << "writer-op: " << ec.message();
-   else
-      std::clog << "writer-op: " << std::size(payload) << " bytes written.";
-
-   std::clog << std::endl;
-}
+   auto& msg = begin_message();
 
-void logger::on_read(system::error_code const& ec, std::size_t n)
-{
-   if (level_ < level::info)
-      return;
-
-   write_prefix();
-
-   if (ec)
-      std::clog << "reader-op: " << ec.message();
-   else
-      std::clog << "reader-op: " << n << " bytes read.";
+   msg += op;
+   if (ec) {
+      detail::append_error(msg, ec);
+   } else {
+      detail::append_number(msg, n);
+      msg += what;
+   }
 
-   std::clog << std::endl;
+   end_message();
 }
 
 void logger::on_run(system::error_code const& reader_ec, system::error_code const& writer_ec)
@@ -124,13 +153,15 @@ void logger::on_run(system::error_code const& reader_ec, system::error_code cons
    if (level_ < level::info)
       return;
 
-   write_prefix();
+   auto& msg = begin_message();
 
-   std::clog << "run-op: "
-      << reader_ec.message() << " (reader), "
-      << writer_ec.message() << " (writer)";
+   msg += "run-op: ";
+   detail::append_error(msg, reader_ec);
+   msg += " (reader), ";
+   detail::append_error(msg, writer_ec);
+   msg += " (writer)";
 
-   std::clog << std::endl;
+   end_message();
 }
 
 void
@@ -141,17 +172,21 @@ logger::on_hello(
    if (level_ < level::info)
       return;
 
-   write_prefix();
+   auto& msg = begin_message();
 
    if (ec) {
-      std::clog << "hello-op: " << ec.message();
-      if (resp.has_error())
-         std::clog << " (" << resp.error().diagnostic << ")";
+      msg += "hello-op: ";
+      detail::append_error(msg, ec);
+      if (resp.has_error()) {
+         msg += " (";
+         msg += resp.error().diagnostic;
+         msg += ")";
+      }
    } else {
-      std::clog << "hello-op: Success";
+      msg += "hello-op: Success";
    }
 
-   std::clog << std::endl;
+   end_message();
 }
 
 void
@@ -163,14 +198,17 @@ void
    if (level_ < level::info)
       return;
 
-   write_prefix();
+   auto& msg = begin_message();
 
-   std::clog << "runner-op: "
-      << run_all_ec.message() << " (async_run_all), "
-      << health_check_ec.message() << " (async_health_check) " 
-      << hello_ec.message() << " (async_hello).";
+   msg += "runner-op: ";
+   detail::append_error(msg, run_all_ec);
+   msg += " (async_run_all), ";
+   detail::append_error(msg, health_check_ec);
+   msg += " (async_health_check) ";
+   detail::append_error(msg, hello_ec);
+   msg += " (async_hello).";
 
-   std::clog << std::endl;
+   end_message();
 }
 
 void
@@ -181,23 +219,22 @@ void
    if (level_ < level::info)
       return;
 
-   write_prefix();
+   auto& msg = begin_message();
 
-   std::clog << "check-health-op: "
-      << ping_ec.message() << " (async_ping), "
-      << timeout_ec.message() << " (async_check_timeout).";
+   msg += "check-health-op: ";
+   detail::append_error(msg, ping_ec);
+   msg += " (async_ping), ";
+   detail::append_error(msg, timeout_ec);
+   msg += " (async_check_timeout).";
 
-   std::clog << std::endl;
+   end_message();
 }
 
-void logger::trace(std::string_view reason)
+void logger::write_trace(std::string_view reason)
 {
-   if (level_ < level::debug)
-      return;
-
-   write_prefix();
-
-   std::clog << reason << std::endl;
+   auto& msg = begin_message();
+   msg += reason;
+   end_message();
 }
 
 } // boost::redis
@@ -0,0 +1,237 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/metrics.hpp>
+#include <boost/redis/detail/number.hpp>
+#include <boost/core/bit.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace boost::redis::detail
+{
+
+template <class T>
+void relaxed_add(std::atomic<T>& a, T v) noexcept
+{
+   a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+template <class T>
+void relaxed_max(std::atomic<T>& a, T v) noexcept
+{
+   if (v > a.load(std::memory_order_relaxed))
+      a.store(v, std::memory_order_relaxed);
+}
+
+auto latency_histogram::index_of(std::uint64_t v) noexcept -> std::size_t
+{
+   v = (std::min)(v, (std::uint64_t{1} << max_bits) - 1);
+   if (v < sub_buckets)
+      return static_cast<std::size_t>(v);
+
+   // Position of the most significant bit, at least sub_bucket_bits.
+   std::size_t const e = 63 - static_cast<std::size_t>(core::countl_zero(v));
+   auto const sub = static_cast<std::size_t>(v >> (e - sub_bucket_bits)) & (sub_buckets - 1);
+   return (e - sub_bucket_bits + 1) * sub_buckets + sub;
+}
+
+auto latency_histogram::lower_bound(std::size_t i) noexcept -> std::uint64_t
+{
+   if (i < sub_buckets)
+      return i;
+
+   std::size_t const e = i / sub_buckets + sub_bucket_bits - 1;
+   std::uint64_t const sub = i % sub_buckets;
+   return (sub_buckets + sub) << (e - sub_bucket_bits);
+}
+
+void latency_histogram::record(std::chrono::nanoseconds d) noexcept
+{
+   auto const v = static_cast<std::uint64_t>((std::max)(d.count(), std::chrono::nanoseconds::rep{0}));
+   relaxed_add(buckets_[index_of(v)], std::uint64_t{1});
+   relaxed_add(total_, v);
+   relaxed_max(max_, v);
+}
+
+void latency_histogram::snapshot(histogram_snapshot& out) const
+{
+   // The count is taken from the buckets so that percentiles are
+   // consistent with it.
+   out.buckets.resize(size);
+   out.count = 0;
+   for (std::size_t i = 0; i < size; ++i) {
+      out.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+      out.count += out.buckets[i];
+   }
+
+   out.total = std::chrono::nanoseconds(total_.load(std::memory_order_relaxed));
+   out.max = std::chrono::nanoseconds(max_.load(std::memory_order_relaxed));
+}
+
+auto next_command(std::string_view payload, std::size_t& pos) noexcept -> std::string_view
+{
+   // Reads the next line, without the separator.
+   auto const line = [&]() -> std::string_view
+   {
+      auto const end = payload.find("\r\n", pos);
+      if (end == std::string_view::npos)
+         return {};
+
+      auto const ret = payload.substr(pos, end - pos);
+      pos = end + 2;
+      return ret;
+   };
+
+   // Requests are arrays of blob strings.
+   auto const header = line();
+   std::size_t n = 0;
+   if (header.empty() || header.front() != '*' || !parse_integer(n, header.substr(1)) || n == 0)
+      return {};
+
+   std::string_view name;
+   for (std::size_t i = 0; i < n; ++i) {
+      auto const blob = line();
+      std::size_t size = 0;
+      if (blob.empty() || blob.front() != '$' || !parse_integer(size, blob.substr(1)))
+         return {};
+
+      if (size + 2 > std::size(payload) - pos)
+         return {};
+
+      if (i == 0)
+         name = payload.substr(pos, size);
+
+      pos += size + 2;
+   }
+
+   return name;
+}
+
+} // boost::redis::detail
+
+namespace boost::redis
+{
+
+auto histogram_snapshot::mean() const noexcept -> std::chrono::nanoseconds
+{
+   if (count == 0)
+      return std::chrono::nanoseconds{0};
+
+   return total / static_cast<std::chrono::nanoseconds::rep>(count);
+}
+
+auto histogram_snapshot::percentile(double p) const noexcept -> std::chrono::nanoseconds
+{
+   using histogram = detail::latency_histogram;
+
+   if (count == 0)
+      return std::chrono::nanoseconds{0};
+
+   p = (std::clamp)(p, 0.0, 1.0);
+   auto const target = (std::max)(std::uint64_t{1}, static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(count))));
+
+   // The upper bound of the bucket where the target is reached,
+   // which is never larger than the largest value recorded.
+   std::uint64_t n = 0;
+   for (std::size_t i = 0; i < std::size(buckets); ++i) {
+      n += buckets[i];
+      if (n >= target) {
+         auto const upper = i + 1 < histogram::size ? histogram::lower_bound(i + 1) - 1 : histogram::lower_bound(i);
+         return (std::min)(std::chrono::nanoseconds(upper), max);
+      }
+   }
+
+   return max;
+}
+
+auto latency_metrics::snapshot() const -> metrics_snapshot
+{
+   metrics_snapshot ret;
+   queue_.snapshot(ret.queue);
+   write_.snapshot(ret.write);
+   response_.snapshot(ret.response);
+
+   auto const append = [&](command_entry const& e, std::string_view name)
+   {
+      command_snapshot cmd;
+      cmd.name = name;
+      cmd.count = e.count.load(std::memory_order_relaxed);
+      cmd.total = std::chrono::nanoseconds(e.total.load(std::memory_order_relaxed));
+      cmd.max = std::chrono::nanoseconds(e.max.load(std::memory_order_relaxed));
+      ret.commands.push_back(std::move(cmd));
+   };
+
+   auto const n = commands_size_.load(std::memory_order_acquire);
+   for (std::size_t i = 0; i < n; ++i)
+      append(commands_[i], std::string_view{commands_[i].name.data(), commands_[i].size});
+
+   auto const& other = commands_[max_commands];
+   if (other.count.load(std::memory_order_relaxed) != 0)
+      append(other, "*");
+
+   ret.max_pending_requests = max_pending_requests_.load(std::memory_order_relaxed);
+   ret.max_write_batch = max_write_batch_.load(std::memory_order_relaxed);
+   return ret;
+}
+
+void latency_metrics::on_exec() noexcept
+{
+   ++pending_requests_;
+   detail::relaxed_max(max_pending_requests_, pending_requests_);
+}
+
+void latency_metrics::on_done() noexcept
+{
+   --pending_requests_;
+}
+
+void latency_metrics::on_staged(std::size_t batch_size) noexcept
+{
+   detail::relaxed_max(max_write_batch_, batch_size);
+}
+
+auto latency_metrics::find_command(std::string_view name) noexcept -> command_entry&
+{
+   auto& other = commands_[max_commands];
+   if (std::size(name) > max_command_size)
+      return other;
+
+   // Names are compared in upper case since commands are case
+   // insensitive.
+   std::array<char, max_command_size> upper{};
+   std::transform(std::cbegin(name), std::cend(name), std::begin(upper), [](char c)
+      { return ('a' <= c && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c; });
+
+   std::string_view const key{upper.data(), std::size(name)};
+
+   // Only the connection adds entries, no need to acquire.
+   auto const n = commands_size_.load(std::memory_order_relaxed);
+   for (std::size_t i = 0; i < n; ++i) {
+      if (std::string_view{commands_[i].name.data(), commands_[i].size} == key)
+         return commands_[i];
+   }
+
+   if (n == max_commands)
+      return other;
+
+   auto& e = commands_[n];
+   e.name = upper;
+   e.size = std::size(name);
+   commands_size_.store(n + 1, std::memory_order_release);
+   return e;
+}
+
+void latency_metrics::record_command(std::string_view name, std::chrono::nanoseconds d) noexcept
+{
+   auto& e = find_command(name);
+   auto const v = static_cast<std::uint64_t>((std::max)(d.count(), std::chrono::nanoseconds::rep{0}));
+   detail::relaxed_add(e.count, std::uint64_t{1});
+   detail::relaxed_add(e.total, v);
+   detail::relaxed_max(e.max, v);
+}
+
+} // boost::redis
@@ -0,0 +1,145 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/number.hpp>
+
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace boost::redis::detail
+{
+
+// Powers of ten that are exactly representable as a double.
+constexpr double exact_powers_of_ten[] =
+{ 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11
+, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+auto parse_double_fallback(double& out, std::string_view sv) -> bool
+{
+#ifdef _LIBCPP_VERSION
+   // libc++ has no std::from_chars for doubles and strtod needs a
+   // null terminated string.
+   char buffer[128];
+   char* end{};
+   if (std::size(sv) < sizeof buffer) {
+      std::memcpy(buffer, sv.data(), std::size(sv));
+      buffer[std::size(sv)] = '\0';
+      out = std::strtod(buffer, &end);
+      return end == buffer + std::size(sv);
+   }
+
+   std::string const tmp{sv};
+   out = std::strtod(tmp.data(), &end);
+   return end == tmp.data() + std::size(tmp);
+#else
+   auto const* const last = sv.data() + std::size(sv);
+   auto const res = std::from_chars(sv.data(), last, out);
+   return res.ec == std::errc() && res.ptr == last;
+#endif // _LIBCPP_VERSION
+}
+
+auto parse_double(double& out, std::string_view sv) -> bool
+{
+   // ,[<+|->]<integral>[.<fractional>][<E|e>[sign]<exponent>]
+   if (sv.empty())
+      return false;
+
+   // Neither std::from_chars nor the parser below accept a plus.
+   auto const number = sv.front() == '+' ? sv.substr(1) : sv;
+
+   auto const* p = sv.data();
+   auto const* const end = p + std::size(sv);
+
+   bool const negative = *p == '-';
+   if (*p == '-' || *p == '+')
+      ++p;
+
+   std::string_view const rest{p, static_cast<std::size_t>(end - p)};
+   if (rest == "inf") {
+      out = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+      return true;
+   }
+
+   if (rest == "nan") {
+      out = std::numeric_limits<double>::quiet_NaN();
+      return true;
+   }
+
+   auto const is_digit = [&]() { return p != end && static_cast<unsigned char>(*p - '0') <= 9; };
+
+   std::uint64_t mantissa = 0;
+   int digits = 0; // Significant digits.
+   int exponent = 0;
+   bool any = false;
+
+   for (; is_digit(); ++p) {
+      any = true;
+      digits += mantissa != 0 || *p != '0';
+      mantissa = 10 * mantissa + static_cast<unsigned char>(*p - '0');
+   }
+
+   if (p != end && *p == '.') {
+      for (++p; is_digit(); ++p) {
+         any = true;
+         digits += mantissa != 0 || *p != '0';
+         mantissa = 10 * mantissa + static_cast<unsigned char>(*p - '0');
+         --exponent;
+      }
+   }
+
+   if (!any)
+      return false;
+
+   if (p != end && (*p == 'e' || *p == 'E')) {
+      ++p;
+      bool const negative_exp = p != end && *p == '-';
+      if (p != end && (*p == '-' || *p == '+'))
+         ++p;
+
+      if (!is_digit())
+         return false;
+
+      int e = 0;
+      for (; is_digit(); ++p) {
+         // Large exponents saturate, the result is then zero or
+         // infinity anyway.
+         if (e < 100000)
+            e = 10 * e + (*p - '0');
+      }
+
+      exponent += negative_exp ? -e : e;
+   }
+
+   if (p != end)
+      return false;
+
+   // The mantissa has overflown, the fallback will deal with it.
+   if (digits > 19)
+      return parse_double_fallback(out, number);
+
+   if (mantissa == 0) {
+      out = negative ? -0.0 : 0.0;
+      return true;
+   }
+
+#if FLT_EVAL_METHOD == 0
+   // Both operands are exact, so is the correctly rounded result,
+   // see Clinger, How to read floating point numbers accurately.
+   if (mantissa <= (std::uint64_t{1} << 53) && -22 <= exponent && exponent <= 22) {
+      auto const m = static_cast<double>(mantissa);
+      auto const d = exponent < 0 ? m / exact_powers_of_ten[-exponent] : m * exact_powers_of_ten[exponent];
+      out = negative ? -d : d;
+      return true;
+   }
+#endif
+
+   return parse_double_fallback(out, number);
+}
+
+} // boost::redis::detail
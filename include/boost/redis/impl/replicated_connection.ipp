@@ -0,0 +1,147 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/replicated_connection.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace boost::redis {
+
+replicated_connection::replicated_connection(
+   executor_type ex,
+   asio::ssl::context::method method,
+   std::size_t max_read_size)
+: ex_{ex}
+, method_{method}
+, max_read_size_{max_read_size}
+, primary_{ex, method, max_read_size}
+, timer_{ex}
+, info_req_{request::config{true, false, true, false}}
+{
+   info_req_.push("INFO", "replication");
+}
+
+auto replicated_connection::get_usable_replicas() const noexcept -> std::size_t
+{
+   auto const n = std::count_if(std::cbegin(replicas_), std::cend(replicas_), [this](auto const& r) { return usable(*r); });
+   return static_cast<std::size_t>(n);
+}
+
+auto replicated_connection::select(request const& req) -> connection&
+{
+   if (rcfg_.policy == read_policy::primary || !detail::is_read_only(req))
+      return primary_;
+
+   auto const n = std::size(replicas_);
+   replica* ret = nullptr;
+   switch (rcfg_.policy) {
+      case read_policy::round_robin:
+      {
+         for (std::size_t i = 0; i < n && !ret; ++i) {
+            auto& r = *replicas_[next_++ % n];
+            if (usable(r))
+               ret = &r;
+         }
+      } break;
+      case read_policy::least_latency:
+      {
+         for (auto& r: replicas_) {
+            if (usable(*r) && (!ret || r->rtt.value() < ret->rtt.value()))
+               ret = r.get();
+         }
+      } break;
+      default:;
+   }
+
+   return ret ? ret->conn : primary_;
+}
+
+void
+replicated_connection::start_run(
+   config const& cfg,
+   replication_config const& rcfg,
+   logger l)
+{
+   cfg_ = cfg;
+   rcfg_ = rcfg;
+   logger_ = l;
+   running_ = true;
+
+   // A replica that hangs must not stall the refresh.
+   ping_req_ = request{request::config{true, true, true, false, rcfg.refresh_interval}};
+   ping_req_.push("PING");
+}
+
+void replicated_connection::run_primary()
+{
+   primary_.async_run(cfg_, logger_, [](system::error_code) {});
+}
+
+void replicated_connection::on_info(system::error_code ec)
+{
+   // Keeps the previous state when the primary can't be reached.
+   if (ec || !info_resp_.has_value() || info_resp_.value().empty())
+      return;
+
+   std::size_t primary_offset = 0;
+   std::vector<detail::replica_info> infos;
+   detail::parse_info_replication(info_resp_.value().front().value, primary_offset, infos);
+
+   // Replicas are never removed, the ones not reported by the
+   // primary anymore are just not used.
+   for (auto& r: replicas_)
+      r->fresh = false;
+
+   for (auto const& info: infos) {
+      auto pos = std::find_if(std::begin(replicas_), std::end(replicas_), [&](auto const& r)
+         { return r->addr.host == info.addr.host && r->addr.port == info.addr.port; });
+
+      if (pos == std::end(replicas_)) {
+         replicas_.push_back(std::make_unique<replica>(ex_, method_, max_read_size_));
+         pos = std::prev(std::end(replicas_));
+         (*pos)->addr = info.addr;
+
+         auto cfg = cfg_;
+         cfg.addr = info.addr;
+         (*pos)->conn.async_run(cfg, logger_, [](system::error_code) {});
+      }
+
+      auto const offset_lag = primary_offset > info.offset ? primary_offset - info.offset : 0;
+      (*pos)->fresh =
+         info.online &&
+         std::chrono::seconds{info.lag} <= rcfg_.max_lag &&
+         offset_lag <= rcfg_.max_offset_lag;
+   }
+}
+
+void
+replicated_connection::on_ping(
+   std::size_t i,
+   system::error_code ec,
+   std::chrono::steady_clock::duration rtt)
+{
+   auto& r = *replicas_[i];
+   r.reachable = !ec;
+   if (ec)
+      return;
+
+   r.rtt.update(rtt);
+}
+
+void replicated_connection::cancel(operation op)
+{
+   if (op == operation::run || op == operation::all) {
+      running_ = false;
+      timer_.cancel();
+   }
+
+   primary_.cancel(op);
+   for (auto& r: replicas_)
+      r->conn.cancel(op);
+}
+
+} // boost::redis
@@ -0,0 +1,139 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/replication.hpp>
+#include <boost/redis/resp3/parser.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+#include <utility>
+
+namespace boost::redis::detail
+{
+
+// Commands with the readonly flag that are useful on a replica,
+// sorted for binary search.
+constexpr std::string_view read_only_commands[] =
+{ "BITCOUNT", "BITFIELD_RO", "BITPOS", "DBSIZE", "DUMP", "EVALSHA_RO"
+, "EVAL_RO", "EXISTS", "EXPIRETIME", "FCALL_RO", "GEODIST", "GEOHASH"
+, "GEOPOS", "GEORADIUSBYMEMBER_RO", "GEORADIUS_RO", "GEOSEARCH", "GET"
+, "GETBIT", "GETRANGE", "HEXISTS", "HGET", "HGETALL", "HKEYS", "HLEN"
+, "HMGET", "HRANDFIELD", "HSCAN", "HSTRLEN", "HVALS", "KEYS", "LCS"
+, "LINDEX", "LLEN", "LPOS", "LRANGE", "MGET", "PEXPIRETIME", "PFCOUNT"
+, "PTTL", "RANDOMKEY", "SCAN", "SCARD", "SDIFF", "SINTER", "SINTERCARD"
+, "SISMEMBER", "SMEMBERS", "SMISMEMBER", "SORT_RO", "SRANDMEMBER"
+, "SSCAN", "STRLEN", "SUBSTR", "SUNION", "TOUCH", "TTL", "TYPE", "XLEN"
+, "XPENDING", "XRANGE", "XREAD", "XREVRANGE", "ZCARD", "ZCOUNT", "ZDIFF"
+, "ZINTER", "ZINTERCARD", "ZLEXCOUNT", "ZMSCORE", "ZRANDMEMBER"
+, "ZRANGE", "ZRANGEBYLEX", "ZRANGEBYSCORE", "ZRANK", "ZREVRANGE"
+, "ZREVRANGEBYLEX", "ZREVRANGEBYSCORE", "ZREVRANK", "ZSCAN", "ZSCORE"
+, "ZUNION"
+};
+
+auto is_read_only_command(std::string_view cmd) noexcept -> bool
+{
+   auto const up = [](char c) { return ('a' <= c && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c; };
+   auto const less = [&](std::string_view a, std::string_view b)
+   {
+      return std::lexicographical_compare(
+         std::cbegin(a), std::cend(a), std::cbegin(b), std::cend(b),
+         [&](char x, char y) { return up(x) < up(y); });
+   };
+
+   auto const pos = std::lower_bound(std::cbegin(read_only_commands), std::cend(read_only_commands), cmd, less);
+   return pos != std::cend(read_only_commands) && !less(cmd, *pos);
+}
+
+auto is_read_only(request const& req) noexcept -> bool
+{
+   if (req.get_commands() == 0)
+      return false;
+
+   // Only the command names i.e. the first element of each array
+   // are inspected.
+   auto payload = req.payload();
+   while (!payload.empty()) {
+      resp3::parser p;
+      bool first = true;
+      while (!p.done()) {
+         system::error_code ec;
+         auto const res = p.consume(payload, ec);
+         if (ec || !res)
+            return false;
+
+         if (res->depth == 1 && std::exchange(first, false) && !is_read_only_command(res->value))
+            return false;
+      }
+
+      payload.remove_prefix(p.get_consumed());
+   }
+
+   return true;
+}
+
+void
+parse_info_replication(
+   std::string_view info,
+   std::size_t& primary_offset,
+   std::vector<replica_info>& replicas)
+{
+   auto const to_number = [](std::string_view s, std::size_t& n)
+      { std::from_chars(s.data(), s.data() + s.size(), n); };
+
+   replicas.clear();
+   while (!info.empty()) {
+      auto const eol = info.find('\n');
+      auto line = info.substr(0, eol);
+      info.remove_prefix(eol == std::string_view::npos ? std::size(info) : eol + 1);
+      if (!line.empty() && line.back() == '\r')
+         line.remove_suffix(1);
+
+      auto const colon = line.find(':');
+      if (colon == std::string_view::npos)
+         continue;
+
+      auto const name = line.substr(0, colon);
+      auto fields = line.substr(colon + 1);
+
+      if (name == "master_repl_offset") {
+         to_number(fields, primary_offset);
+         continue;
+      }
+
+      // slaveN:ip=...,port=...,state=...,offset=...,lag=...
+      if (name.substr(0, 5) != "slave" || std::size(name) == 5 || !std::all_of(std::cbegin(name) + 5, std::cend(name), [](char c) { return '0' <= c && c <= '9'; }))
+         continue;
+
+      replica_info r;
+      while (!fields.empty()) {
+         auto const comma = fields.find(',');
+         auto const field = fields.substr(0, comma);
+         fields.remove_prefix(comma == std::string_view::npos ? std::size(fields) : comma + 1);
+
+         auto const eq = field.find('=');
+         if (eq == std::string_view::npos)
+            continue;
+
+         auto const key = field.substr(0, eq);
+         auto const value = field.substr(eq + 1);
+         if (key == "ip")
+            r.addr.host = value;
+         else if (key == "port")
+            r.addr.port = value;
+         else if (key == "state")
+            r.online = value == "online";
+         else if (key == "offset")
+            to_number(value, r.offset);
+         else if (key == "lag")
+            to_number(value, r.lag);
+      }
+
+      replicas.push_back(std::move(r));
+   }
+}
+
+} // boost::redis::detail
@@ -6,6 +6,8 @@
 
 #include <boost/redis/request.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <string_view>
 
 namespace boost::redis::detail {
@@ -15,7 +17,16 @@ auto has_response(std::string_view cmd) -> bool
    if (cmd == "SUBSCRIBE") return true;
    if (cmd == "PSUBSCRIBE") return true;
    if (cmd == "UNSUBSCRIBE") return true;
+   if (cmd == "PUNSUBSCRIBE") return true;
+   if (cmd == "SSUBSCRIBE") return true;
+   if (cmd == "SUNSUBSCRIBE") return true;
    return false;
 }
 
+auto iequals(std::string_view a, std::string_view b) noexcept -> bool
+{
+   auto const up = [](char c) { return ('a' <= c && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c; };
+   return std::size(a) == std::size(b) && std::equal(std::cbegin(a), std::cend(a), std::cbegin(b), [&](char x, char y) { return up(x) == up(y); });
+}
+
 } // boost:redis::detail
@@ -45,4 +45,20 @@ void consume_one(generic_response& r)
       throw system::system_error(ec);
 }
 
+void consume_one(generic_queue_response& r, system::error_code&)
+{
+   if (r.has_error())
+      return; // Nothing to consume.
+
+   r.value().pop_front();
+}
+
+void consume_one(generic_queue_response& r)
+{
+   system::error_code ec;
+   consume_one(r, ec);
+   if (ec)
+      throw system::system_error(ec);
+}
+
 } // boost::redis::resp3
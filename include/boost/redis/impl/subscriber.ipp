@@ -0,0 +1,112 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/subscriber.hpp>
+
+namespace boost::redis {
+
+subscriber::subscriber(
+   executor_type ex,
+   asio::ssl::context::method method,
+   std::size_t max_read_size)
+: conn_{ex, method, max_read_size}
+// Must not be cancelled when the connection is lost so it is written
+// once the connection has been reestablished.
+, resubscribe_req_{{false, false, true, true}}
+{
+   conn_.set_receive_response(queue_);
+}
+
+void subscriber::set_handler(std::string_view channel, handler_type handler)
+{
+   if (handler)
+      handlers_[std::string{channel}] = std::move(handler);
+   else
+      handlers_.erase(std::string{channel});
+}
+
+void subscriber::start_run(config const& cfg, logger l)
+{
+   cfg_ = cfg;
+   logger_ = l;
+}
+
+void subscriber::run_connection()
+{
+   // Stops the receive loop when the connection is not reconnecting
+   // anymore.
+   conn_.async_run(cfg_, logger_, [this](system::error_code) {
+      conn_.cancel(operation::receive);
+   });
+}
+
+auto
+subscriber::make_request(
+   std::string_view cmd,
+   std::vector<std::string> const& channels) -> std::unique_ptr<request>
+{
+   auto const update = [&](std::set<std::string>& subscriptions, bool subscribe)
+   {
+      if (subscribe) {
+         subscriptions.insert(std::cbegin(channels), std::cend(channels));
+      } else if (channels.empty()) {
+         subscriptions.clear();
+      } else {
+         for (auto const& channel: channels)
+            subscriptions.erase(channel);
+      }
+   };
+
+   if (cmd == "SUBSCRIBE" || cmd == "UNSUBSCRIBE")
+      update(channels_, cmd == "SUBSCRIBE");
+   else if (cmd == "PSUBSCRIBE" || cmd == "PUNSUBSCRIBE")
+      update(patterns_, cmd == "PSUBSCRIBE");
+   else
+      update(shard_channels_, cmd == "SSUBSCRIBE");
+
+   auto req = std::make_unique<request>();
+   req->push_range(cmd, channels);
+   return req;
+}
+
+bool subscriber::make_resubscribe_request()
+{
+   resubscribe_req_.clear();
+
+   if (!channels_.empty())
+      resubscribe_req_.push_range("SUBSCRIBE", channels_);
+
+   if (!patterns_.empty())
+      resubscribe_req_.push_range("PSUBSCRIBE", patterns_);
+
+   if (!shard_channels_.empty())
+      resubscribe_req_.push_range("SSUBSCRIBE", shard_channels_);
+
+   return resubscribe_req_.get_commands() != 0;
+}
+
+void subscriber::dispatch()
+{
+   for (std::size_t i = 0; i < queue_.size; ++i) {
+      auto const& msg = queue_.messages[i];
+      auto const& key = msg.kind == pubsub_kind::pmessage ? msg.pattern : msg.channel;
+
+      auto const pos = handlers_.find(key);
+      if (pos != std::end(handlers_)) {
+         pos->second(msg);
+         ++dispatched_;
+      } else if (default_handler_) {
+         default_handler_(msg);
+         ++dispatched_;
+      } else {
+         ++dropped_;
+      }
+   }
+
+   queue_.clear();
+}
+
+} // boost::redis
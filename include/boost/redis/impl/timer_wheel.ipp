@@ -0,0 +1,122 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/timer_wheel.hpp>
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace boost::redis::detail
+{
+
+timer_wheel::timer_wheel(
+   clock_type::time_point origin,
+   clock_type::duration resolution)
+: origin_{origin}
+, resolution_{resolution}
+{
+   BOOST_ASSERT(resolution_ > clock_type::duration::zero());
+}
+
+auto timer_wheel::to_tick(clock_type::time_point t) const noexcept -> std::uint64_t
+{
+   if (t <= origin_)
+      return 0;
+
+   return static_cast<std::uint64_t>((t - origin_) / resolution_);
+}
+
+void timer_wheel::schedule(timer_wheel_node& node, clock_type::time_point deadline) noexcept
+{
+   BOOST_ASSERT(!node.is_scheduled());
+
+   // Rounds up so that nodes never expire early.
+   std::uint64_t tick = 0;
+   if (deadline > origin_) {
+      auto const d = deadline - origin_;
+      tick = static_cast<std::uint64_t>((d + resolution_ - clock_type::duration{1}) / resolution_);
+   }
+
+   node.tick_ = (std::max)(tick, current_ + 1);
+   place(node);
+   ++size_;
+}
+
+void timer_wheel::cancel(timer_wheel_node& node) noexcept
+{
+   if (!node.is_scheduled())
+      return;
+
+   node.hook_.unlink();
+   --size_;
+}
+
+void timer_wheel::place(timer_wheel_node& node) noexcept
+{
+   // Nodes that expire at the current tick only come from cascade
+   // and are expired right after it.
+   auto const delta = node.tick_ > current_ ? node.tick_ - current_ : 0;
+
+   // A node in level l is at most 64 slots ahead of the current
+   // one, so its slot is cascaded when the wheel reaches its tick.
+   for (std::size_t l = 0; l < levels; ++l) {
+      auto const shift = slot_bits * l;
+      if (delta < (std::uint64_t{1} << (shift + slot_bits))) {
+         wheel_[l][(node.tick_ >> shift) % slots].push_back(node);
+         return;
+      }
+   }
+
+   // Out of range, parked in the farthest slot of the top level
+   // until it comes in range.
+   auto const shift = slot_bits * (levels - 1);
+   auto const parked = current_ + (std::uint64_t{1} << (shift + slot_bits)) - 1;
+   wheel_[levels - 1][(parked >> shift) % slots].push_back(node);
+}
+
+void timer_wheel::cascade() noexcept
+{
+   // From the top so that nodes moved to a level that is also
+   // being cascaded go further down.
+   for (std::size_t l = levels - 1; l != 0; --l) {
+      auto const shift = slot_bits * l;
+      if ((current_ & ((std::uint64_t{1} << shift) - 1)) != 0)
+         continue;
+
+      list_type tmp;
+      tmp.splice(std::cend(tmp), wheel_[l][(current_ >> shift) % slots]);
+      while (!tmp.empty()) {
+         auto& node = tmp.front();
+         tmp.pop_front();
+         place(node);
+      }
+   }
+}
+
+auto timer_wheel::next_expiry() const noexcept -> clock_type::time_point
+{
+   if (size_ == 0)
+      return (clock_type::time_point::max)();
+
+   // The first non-empty slot of each level, for levels above zero
+   // the tick at which it is cascaded.
+   auto next = (std::numeric_limits<std::uint64_t>::max)();
+   for (std::size_t l = 0; l < levels; ++l) {
+      auto const shift = slot_bits * l;
+      auto const base = current_ >> shift;
+      for (std::uint64_t i = 1; i <= slots; ++i) {
+         if (!wheel_[l][(base + i) % slots].empty()) {
+            next = (std::min)(next, (base + i) << shift);
+            break;
+         }
+      }
+   }
+
+   return origin_ + static_cast<clock_type::rep>(next) * resolution_;
+}
+
+} // boost::redis::detail
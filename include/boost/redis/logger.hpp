@@ -9,7 +9,9 @@
 
 #include <boost/redis/response.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <algorithm>
 #include <string>
+#include <string_view>
 
 namespace boost::system {class error_code;}
 
@@ -23,6 +25,11 @@ namespace boost::redis {
  *  Notice that currently this class has no stable interface. Users
  *  that don't want any logging can disable it by contructing a logger
  *  with logger::level::emerg to the connection.
+ *
+ *  Messages are only formatted when their level is enabled, into a
+ *  buffer that is reused between messages, and written to `stderr`
+ *  with a single call. To remove disabled calls at compile time see
+ *  `basic_logger`.
  */
 class logger {
 public:
@@ -102,9 +109,13 @@ public:
     *  @ingroup high-level-api
     *
     *  @param ec Error code returned by the write operation.
-    *  @param payload The payload written to the socket.
+    *  @param n Number of bytes written.
     */
-   void on_write(system::error_code const& ec, std::string const& payload);
+   void on_write(system::error_code const& ec, std::size_t n)
+   {
+      if (level_ >= level::info)
+         write_io("writer-op: ", ec, n, " bytes written.");
+   }
 
    /** @brief Called when the read operation completes.
     *  @ingroup high-level-api
@@ -112,7 +123,11 @@ public:
     *  @param ec Error code returned by the read operation.
     *  @param n Number of bytes read.
     */
-   void on_read(system::error_code const& ec, std::size_t n);
+   void on_read(system::error_code const& ec, std::size_t n)
+   {
+      if (level_ >= level::info)
+         write_io("reader-op: ", ec, n, " bytes read.");
+   }
 
    /** @brief Called when the run operation completes.
     *  @ingroup high-level-api
@@ -158,12 +173,153 @@ public:
          system::error_code const& ping_ec,
          system::error_code const& check_timeout_ec);
 
-   void trace(std::string_view reason);
+   void trace(std::string_view reason)
+   {
+      if (level_ >= level::debug)
+         write_trace(reason);
+   }
+
+   /// Returns the log level.
+   auto get_level() const noexcept
+      { return level_; }
 
 private:
-   void write_prefix();
+   void write_io(std::string_view op, system::error_code const& ec, std::size_t n, std::string_view what);
+   void write_trace(std::string_view reason);
+
+   // Starts a message with the prefix and writes it.
+   auto begin_message() -> std::string&;
+   void end_message();
+
    level level_;
    std::string_view prefix_;
+
+   // Reused by all messages, see begin_message.
+   std::string buffer_;
+};
+
+/** @brief Logger with a maximum log level known at compile time.
+ *  @ingroup high-level-api
+ *
+ *  Calls above `MaxLevel` compile to nothing, including the check of
+ *  the level at runtime. The others behave as in `logger`. For
+ *  example, to remove all logging from the reader and writer
+ *
+ *  @code
+ *  conn.async_run(cfg, basic_logger<logger::level::disabled>{}, token);
+ *  @endcode
+ *
+ *  or to keep errors and above only
+ *
+ *  @code
+ *  conn.async_run(cfg, basic_logger<logger::level::err>{logger::level::err}, token);
+ *  @endcode
+ *
+ *  Only `basic_connection::async_run` and `connection::async_run`
+ *  keep the logger type. `connection_pool`, `cluster_connection`,
+ *  `replicated_connection`, `cached_connection` and `subscriber`
+ *  store a `logger`, so a `basic_logger` passed to them is converted
+ *  and its level is only enforced at runtime.
+ *
+ *  @tparam MaxLevel The highest level that can be logged.
+ */
+template <logger::level MaxLevel>
+class basic_logger : public logger {
+public:
+   /// The highest level that can be logged.
+   static constexpr level max_level = MaxLevel;
+
+   /** @brief Constructor
+    *
+    *  @param l Log level, levels above `MaxLevel` are ignored.
+    */
+   basic_logger(level l = MaxLevel)
+   : logger{(std::min)(l, MaxLevel)}
+   {}
+
+   /// Calls `logger::on_resolve` if info messages are enabled.
+   void on_resolve(system::error_code const& ec, asio::ip::tcp::resolver::results_type const& res)
+   {
+      if constexpr (MaxLevel >= level::info)
+         logger::on_resolve(ec, res);
+   }
+
+   /// Calls `logger::on_connect` if info messages are enabled.
+   void on_connect(system::error_code const& ec, asio::ip::tcp::endpoint const& ep)
+   {
+      if constexpr (MaxLevel >= level::info)
+         logger::on_connect(ec, ep);
+   }
+
+   /// Calls `logger::on_ssl_handshake` if info messages are enabled.
+   void on_ssl_handshake(system::error_code const& ec)
+   {
+      if constexpr (MaxLevel >= level::info)
+         logger::on_ssl_handshake(ec);
+   }
+
+   /// Calls `logger::on_connection_lost` if info messages are enabled.
+   void on_connection_lost(system::error_code const& ec)
+   {
+      if constexpr (MaxLevel >= level::info)
+         logger::on_connection_lost(ec);
+   }
+
+   /// Calls `logger::on_write` if info messages are enabled.
+   void on_write(system::error_code const& ec, std::size_t n)
+   {
+      if constexpr (MaxLevel >= level::info)
+         logger::on_write(ec, n);
+   }
+
+   /// Calls `logger::on_read` if info messages are enabled.
+   void on_read(system::error_code const& ec, std::size_t n)
+   {
+      if constexpr (MaxLevel >= level::info)
+         logger::on_read(ec, n);
+   }
+
+   /// Calls `logger::on_run` if info messages are enabled.
+   void on_run(system::error_code const& reader_ec, system::error_code const& writer_ec)
+   {
+      if constexpr (MaxLevel >= level::info)
+         logger::on_run(reader_ec, writer_ec);
+   }
+
+   /// Calls `logger::on_hello` if info messages are enabled.
+   void on_hello(system::error_code const& ec, generic_response const& resp)
+   {
+      if constexpr (MaxLevel >= level::info)
+         logger::on_hello(ec, resp);
+   }
+
+   /// Calls `logger::on_runner` if info messages are enabled.
+   void
+      on_runner(
+         system::error_code const& run_all_ec,
+         system::error_code const& health_check_ec,
+         system::error_code const& hello_ec)
+   {
+      if constexpr (MaxLevel >= level::info)
+         logger::on_runner(run_all_ec, health_check_ec, hello_ec);
+   }
+
+   /// Calls `logger::on_check_health` if info messages are enabled.
+   void
+      on_check_health(
+         system::error_code const& ping_ec,
+         system::error_code const& check_timeout_ec)
+   {
+      if constexpr (MaxLevel >= level::info)
+         logger::on_check_health(ping_ec, check_timeout_ec);
+   }
+
+   /// Calls `logger::trace` if debug messages are enabled.
+   void trace(std::string_view reason)
+   {
+      if constexpr (MaxLevel >= level::debug)
+         logger::trace(reason);
+   }
 };
 
 } // boost::redis
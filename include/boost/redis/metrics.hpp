@@ -0,0 +1,228 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_METRICS_HPP
+#define BOOST_REDIS_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis
+{
+
+/** @brief Latencies of the requests with the same duration.
+ *  @ingroup high-level-api
+ *
+ *  Recorded latencies are grouped in buckets whose width is at most
+ *  1/32 of their lower bound, percentiles are therefore accurate to
+ *  about 3%. Latencies above 2^36 ns (about 68 s) are counted in the
+ *  last bucket.
+ */
+struct histogram_snapshot {
+   /// Number of recorded latencies.
+   std::uint64_t count = 0;
+
+   /// Sum of the recorded latencies.
+   std::chrono::nanoseconds total{0};
+
+   /// Largest recorded latency.
+   std::chrono::nanoseconds max{0};
+
+   /// Number of latencies in each bucket.
+   std::vector<std::uint64_t> buckets;
+
+   /// Returns the mean latency.
+   auto mean() const noexcept -> std::chrono::nanoseconds;
+
+   /** @brief Returns the latency below which a fraction of the
+    *  recorded latencies fall.
+    *
+    *  @param p The fraction in [0, 1] e.g. 0.99 for the 99th percentile.
+    */
+   auto percentile(double p) const noexcept -> std::chrono::nanoseconds;
+};
+
+/** @brief Metrics of the commands with the same name.
+ *  @ingroup high-level-api
+ */
+struct command_snapshot {
+   /// The command name in upper case or `*` for the commands that didn't fit in the table.
+   std::string name;
+
+   /// Number of responses received.
+   std::uint64_t count = 0;
+
+   /// Sum of the times from writing the request to receiving the response.
+   std::chrono::nanoseconds total{0};
+
+   /// Largest time from writing the request to receiving the response.
+   std::chrono::nanoseconds max{0};
+};
+
+/** @brief Connection metrics, see `latency_metrics::snapshot`.
+ *  @ingroup high-level-api
+ */
+struct metrics_snapshot {
+   /// Time from `async_exec` to the request being staged for writing.
+   histogram_snapshot queue;
+
+   /// Time from staging to the completion of the write.
+   histogram_snapshot write;
+
+   /// Time from the completion of the write to the last response.
+   histogram_snapshot response;
+
+   /// Metrics per command name, in the order they were first seen.
+   std::vector<command_snapshot> commands;
+
+   /// Largest number of requests passed to `async_exec` and not yet completed.
+   std::size_t max_pending_requests = 0;
+
+   /// Largest number of requests coalesced in a single write.
+   std::size_t max_write_batch = 0;
+};
+
+/** @brief Metrics policy that records nothing.
+ *  @ingroup high-level-api
+ *
+ *  The default of `basic_connection`, it adds no state or
+ *  instructions to the connection.
+ */
+struct no_metrics {
+   static constexpr bool enabled = false;
+};
+
+namespace detail
+{
+
+// A log-linear histogram of latencies in nanoseconds, similar to HDR
+// histograms. Values below 32 have their own bucket, larger ones are
+// grouped in 32 buckets per power of two.
+//
+// Written only by the connection, the atomics make it safe to take
+// snapshots from other threads. Since there is a single writer,
+// updates are a relaxed load and store rather than a locked
+// read-modify-write.
+class latency_histogram {
+public:
+   static constexpr std::size_t sub_bucket_bits = 5;
+   static constexpr std::size_t sub_buckets = 1 << sub_bucket_bits;
+   static constexpr std::size_t max_bits = 36;
+   static constexpr std::size_t size = (max_bits - sub_bucket_bits + 1) * sub_buckets;
+
+   // Returns the bucket of the value.
+   static auto index_of(std::uint64_t v) noexcept -> std::size_t;
+
+   // Returns the smallest value in the bucket.
+   static auto lower_bound(std::size_t i) noexcept -> std::uint64_t;
+
+   void record(std::chrono::nanoseconds d) noexcept;
+   void snapshot(histogram_snapshot& out) const;
+
+private:
+   std::array<std::atomic<std::uint64_t>, size> buckets_{};
+   std::atomic<std::uint64_t> total_{0};
+   std::atomic<std::uint64_t> max_{0};
+};
+
+// Returns the name of the command that starts at pos in a request
+// payload and moves pos to the next command. Returns an empty view
+// if the payload is malformed.
+auto next_command(std::string_view payload, std::size_t& pos) noexcept -> std::string_view;
+
+} // detail
+
+/** @brief Metrics policy that records latencies.
+ *  @ingroup high-level-api
+ *
+ *  Passed as the `Metrics` parameter of `basic_connection` it records
+ *
+ *  @li The time requests spend waiting to be written, being written
+ *      and waiting for their responses, in histograms.
+ *  @li The number of responses and their latency per command name.
+ *  @li High-water marks of the number of pending requests and of the
+ *      size of the write batches.
+ *
+ *  The metrics are updated by the connection and can be read from
+ *  any thread with `snapshot`, for example
+ *
+ *  @code
+ *  basic_connection<asio::any_io_executor, latency_metrics> conn{ex};
+ *  ...
+ *  auto const m = conn.get_metrics().snapshot();
+ *  std::cout << m.response.percentile(0.99).count() << std::endl;
+ *  @endcode
+ *
+ *  Metrics are not reset on reconnection. Up to `max_commands`
+ *  command names are tracked individually, the others are added to
+ *  a single entry named `*`.
+ */
+class latency_metrics {
+public:
+   static constexpr bool enabled = true;
+
+   /// Maximum number of command names tracked individually.
+   static constexpr std::size_t max_commands = 64;
+
+   /// Maximum length of the command names tracked individually.
+   static constexpr std::size_t max_command_size = 31;
+
+   using clock_type = std::chrono::steady_clock;
+
+   /// Returns a copy of the metrics.
+   auto snapshot() const -> metrics_snapshot;
+
+   // Called by the connection.
+   void on_exec() noexcept;
+   void on_done() noexcept;
+   void on_staged(std::size_t batch_size) noexcept;
+
+   void record_queue(std::chrono::nanoseconds d) noexcept
+      { queue_.record(d); }
+
+   void record_write(std::chrono::nanoseconds d) noexcept
+      { write_.record(d); }
+
+   void record_response(std::chrono::nanoseconds d) noexcept
+      { response_.record(d); }
+
+   void record_command(std::string_view name, std::chrono::nanoseconds d) noexcept;
+
+private:
+   struct command_entry {
+      std::array<char, max_command_size> name{};
+      std::size_t size = 0;
+      std::atomic<std::uint64_t> count{0};
+      std::atomic<std::uint64_t> total{0};
+      std::atomic<std::uint64_t> max{0};
+   };
+
+   auto find_command(std::string_view name) noexcept -> command_entry&;
+
+   detail::latency_histogram queue_;
+   detail::latency_histogram write_;
+   detail::latency_histogram response_;
+
+   // Entries are published by incrementing commands_size_, their
+   // names don't change afterwards. The last one is the overflow
+   // entry.
+   std::array<command_entry, max_commands + 1> commands_;
+   std::atomic<std::size_t> commands_size_{0};
+
+   std::size_t pending_requests_ = 0;
+   std::atomic<std::size_t> max_pending_requests_{0};
+   std::atomic<std::size_t> max_write_batch_{0};
+};
+
+} // boost::redis
+
+#endif // BOOST_REDIS_METRICS_HPP
@@ -0,0 +1,132 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_OBSERVER_HPP
+#define BOOST_REDIS_OBSERVER_HPP
+
+#include <boost/system/error_code.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace boost::redis
+{
+
+class request;
+
+/** @brief Clock of the request events.
+ *  @ingroup high-level-api
+ */
+using event_clock = std::chrono::steady_clock;
+
+/** @brief An `async_exec` operation started.
+ *  @ingroup high-level-api
+ *
+ *  Sent when the operation is initiated, not when `async_exec` is
+ *  called, so that e.g. a deferred operation that is never launched
+ *  sends no event. It is always followed by a `completion_event`.
+ */
+struct enqueue_event {
+   /// Identifies the request in the other events, unique per connection.
+   std::uint64_t id = 0;
+
+   /// Time of the event.
+   event_clock::time_point time;
+
+   /// The request, valid until the `completion_event`.
+   request const* req = nullptr;
+};
+
+/** @brief The request was coalesced with others for writing.
+ *  @ingroup high-level-api
+ */
+struct stage_event {
+   /// The request id, see `enqueue_event`.
+   std::uint64_t id = 0;
+
+   /// Time of the event.
+   event_clock::time_point time;
+};
+
+/** @brief The write of the request completed.
+ *  @ingroup high-level-api
+ *
+ *  Requests are written again after a reconnection, in which case
+ *  the stage and write events are sent again.
+ */
+struct write_event {
+   /// The request id, see `enqueue_event`.
+   std::uint64_t id = 0;
+
+   /// Time of the event.
+   event_clock::time_point time;
+};
+
+/** @brief The connection started reading the first response of the request.
+ *  @ingroup high-level-api
+ */
+struct first_byte_event {
+   /// The request id, see `enqueue_event`.
+   std::uint64_t id = 0;
+
+   /// Time of the event.
+   event_clock::time_point time;
+};
+
+/** @brief A response of the request was parsed.
+ *  @ingroup high-level-api
+ */
+struct parse_event {
+   /// The request id, see `enqueue_event`.
+   std::uint64_t id = 0;
+
+   /// Time of the event.
+   event_clock::time_point time;
+
+   /// Index of the response in the request.
+   std::size_t index = 0;
+
+   /// Size of the response in bytes.
+   std::size_t size = 0;
+};
+
+/** @brief The `async_exec` operation is about to complete.
+ *  @ingroup high-level-api
+ */
+struct completion_event {
+   /// The request id, see `enqueue_event`.
+   std::uint64_t id = 0;
+
+   /// Time of the event.
+   event_clock::time_point time;
+
+   /// The error passed to the completion handler.
+   system::error_code ec;
+
+   /// The size passed to the completion handler.
+   std::size_t size = 0;
+};
+
+/** @brief Observer that ignores all events.
+ *  @ingroup high-level-api
+ *
+ *  The default of `basic_connection`. The connection doesn't assign
+ *  request ids nor reads the clock when it is used.
+ */
+struct no_observer {};
+
+namespace detail
+{
+
+template <class Observer>
+inline constexpr bool is_observed = !std::is_same_v<Observer, no_observer>;
+
+} // detail
+} // boost::redis
+
+#endif // BOOST_REDIS_OBSERVER_HPP
@@ -0,0 +1,48 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_PUBSUB_MESSAGE_HPP
+#define BOOST_REDIS_PUBSUB_MESSAGE_HPP
+
+#include <string>
+
+namespace boost::redis
+{
+
+/** @brief The kind of a Pub/Sub message.
+ *  @ingroup high-level-api
+ */
+enum class pubsub_kind {
+   /// Published on a channel subscribed with `SUBSCRIBE`.
+   message,
+   /// Published on a channel that matches a pattern subscribed with `PSUBSCRIBE`.
+   pmessage,
+   /// Published on a shard channel subscribed with `SSUBSCRIBE`.
+   smessage,
+};
+
+/** @brief A message published on a channel.
+ *  @ingroup high-level-api
+ *
+ *  See `boost::redis::subscriber`.
+ */
+struct pubsub_message {
+   /// The kind of message.
+   pubsub_kind kind = pubsub_kind::message;
+
+   /// The pattern that matched the channel, empty unless the kind is `pubsub_kind::pmessage`.
+   std::string pattern;
+
+   /// The channel on which the message has been published.
+   std::string channel;
+
+   /// The message.
+   std::string payload;
+};
+
+} // boost::redis
+
+#endif // BOOST_REDIS_PUBSUB_MESSAGE_HPP
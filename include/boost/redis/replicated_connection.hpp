@@ -0,0 +1,290 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_REPLICATED_CONNECTION_HPP
+#define BOOST_REDIS_REPLICATED_CONNECTION_HPP
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/config.hpp>
+#include <boost/redis/logger.hpp>
+#include <boost/redis/operation.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/response.hpp>
+#include <boost/redis/detail/replication.hpp>
+#include <boost/redis/detail/rtt.hpp>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace boost::redis {
+
+/// Selects the replica that executes read-only requests.
+enum class read_policy {
+   /// Sends all requests to the primary.
+   primary,
+
+   /// Rotates over the usable replicas.
+   round_robin,
+
+   /// Sends to the usable replica with the lowest round-trip time.
+   least_latency,
+};
+
+/// Configuration of `boost::redis::replicated_connection`.
+struct replication_config {
+   /// How replicas are selected for read-only requests.
+   read_policy policy = read_policy::round_robin;
+
+   /** @brief Maximum replication lag of a usable replica.
+    *
+    *  The lag is the time since the replica last acknowledged the
+    *  replication stream, as reported by `INFO replication` on the
+    *  primary.
+    */
+   std::chrono::seconds max_lag = std::chrono::seconds{10};
+
+   /** @brief Maximum number of bytes a usable replica may be behind the primary.
+    *
+    *  To disable pass `(std::numeric_limits<std::size_t>::max)()`.
+    */
+   std::size_t max_offset_lag = (std::numeric_limits<std::size_t>::max)();
+
+   /// Interval between refreshes of the replica list and their round-trip times.
+   std::chrono::steady_clock::duration refresh_interval = std::chrono::seconds{5};
+};
+
+namespace detail
+{
+
+// Waits for the pings of a refresh to complete.
+template <class Self>
+struct replicated_ping_join {
+   Self self;
+   std::size_t pending;
+
+   void on_done()
+   {
+      if (--pending == 0)
+         self(system::error_code{}, 0);
+   }
+};
+
+template <class Conn>
+struct replicated_run_op {
+   Conn* conn_;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro)
+      {
+         conn_->run_primary();
+
+         while (conn_->running_) {
+            conn_->info_resp_ = generic_response{};
+            BOOST_ASIO_CORO_YIELD
+            conn_->primary_.async_exec(conn_->info_req_, conn_->info_resp_, std::move(self));
+
+            if (!conn_->running_)
+               break;
+
+            conn_->on_info(ec);
+
+            // Measures the round-trip time to the replicas
+            // concurrently. Replicas that are not connected fail right
+            // away and the ones that don't answer within the refresh
+            // interval time out, either way they are not used until
+            // the next refresh.
+            if (!std::empty(conn_->replicas_)) {
+               BOOST_ASIO_CORO_YIELD
+               {
+                  // The op is moved into the join, use only locals
+                  // from here on.
+                  auto* conn = conn_;
+                  auto const start = std::chrono::steady_clock::now();
+                  auto const n = std::size(conn->replicas_);
+                  auto join = std::make_shared<replicated_ping_join<Self>>(replicated_ping_join<Self>{std::move(self), n});
+                  for (std::size_t i = 0; i < n; ++i) {
+                     conn->replicas_[i]->conn.async_exec(conn->ping_req_, ignore, [conn, join, i, start](system::error_code ec, std::size_t) {
+                        if (conn->running_)
+                           conn->on_ping(i, ec, std::chrono::steady_clock::now() - start);
+                        join->on_done();
+                     });
+                  }
+               }
+            }
+
+            if (!conn_->running_)
+               break;
+
+            conn_->timer_.expires_after(conn_->rcfg_.refresh_interval);
+            BOOST_ASIO_CORO_YIELD
+            conn_->timer_.async_wait(std::move(self));
+         }
+
+         self.complete(asio::error::operation_aborted);
+      }
+   }
+};
+
+} // detail
+
+/** @brief A connection to a primary and its replicas.
+ *  @ingroup high-level-api
+ *
+ *  Connects to the primary in `config::addr` and discovers its
+ *  replicas with `INFO replication`, which is refreshed periodically.
+ *  Requests whose commands are all read-only, e.g. `GET` or
+ *  `HGETALL`, are sent to a replica chosen by
+ *  `replication_config::policy`, all others to the primary. Replicas
+ *  that are not connected, not online or lag behind the primary more
+ *  than the configured bounds are not used. When no replica is
+ *  usable requests are sent to the primary.
+ *
+ *  Notice that reads sent to replicas might not observe writes
+ *  sent before to the primary. To resolve the primary with Sentinel
+ *  see cpp20_resolve_with_sentinel.cpp.
+ *
+ *  This class is not thread-safe, like `boost::redis::connection`.
+ */
+class replicated_connection {
+public:
+   /// Executor type.
+   using executor_type = asio::any_io_executor;
+
+   /** @brief Constructor
+    *
+    *  @param ex Executor on which the connections run.
+    *  @param method SSL method used by the connections.
+    *  @param max_read_size See `boost::redis::basic_connection`.
+    */
+   explicit
+   replicated_connection(
+      executor_type ex,
+      asio::ssl::context::method method = asio::ssl::context::tls_client,
+      std::size_t max_read_size = (std::numeric_limits<std::size_t>::max)());
+
+   /// Returns the underlying executor.
+   executor_type get_executor() noexcept
+      { return ex_; }
+
+   /// Returns the connection to the primary.
+   auto primary() noexcept -> connection&
+      { return primary_; }
+
+   /// Returns the number of replicas that read-only requests can be sent to.
+   auto get_usable_replicas() const noexcept -> std::size_t;
+
+   /** @brief Starts the connections.
+    *
+    *  Connects to the primary in `cfg.addr` and to the replicas as
+    *  they are discovered. Each connection reconnects and checks
+    *  health on its own, see
+    *  `boost::redis::basic_connection::async_run`.
+    *
+    *  @param cfg Configuration parameters used by all connections.
+    *  @param rcfg Replication configuration.
+    *  @param l Logger object, converted to `logger`, see `boost::redis::basic_logger`.
+    *  @param token Completion token with signature `void(system::error_code)`.
+    */
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto
+   async_run(
+      config const& cfg = {},
+      replication_config const& rcfg = {},
+      logger l = logger{},
+      CompletionToken token = CompletionToken{})
+   {
+      start_run(cfg, rcfg, l);
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code)
+         >(detail::replicated_run_op<replicated_connection>{this}, token, timer_);
+   }
+
+   /** @brief Executes a request.
+    *
+    *  See `boost::redis::basic_connection::async_exec`. Read-only
+    *  requests are sent to a replica, all others to the primary.
+    */
+   template <
+      class Response = ignore_t,
+      class CompletionToken = asio::default_completion_token_t<executor_type>
+   >
+   auto
+   async_exec(
+      request const& req,
+      Response& resp = ignore,
+      CompletionToken token = CompletionToken{})
+   {
+      return select(req).async_exec(req, resp, std::move(token));
+   }
+
+   /** @brief Cancel operations.
+    *
+    *  Calls `boost::redis::basic_connection::cancel` on the primary
+    *  and the replicas. `operation::run` and `operation::all` also
+    *  stop the refreshes.
+    */
+   void cancel(operation op = operation::all);
+
+private:
+   template <class> friend struct detail::replicated_run_op;
+
+   struct replica {
+      replica(executor_type ex, asio::ssl::context::method method, std::size_t max_read_size)
+      : conn{ex, method, max_read_size}
+      { }
+
+      address addr;
+      connection conn;
+
+      // Whether the primary reports it within the staleness bounds
+      // and whether the last ping succeeded.
+      bool fresh = false;
+      bool reachable = false;
+
+      // Smoothed round-trip time of the pings.
+      detail::smoothed_rtt rtt;
+   };
+
+   auto usable(replica const& r) const noexcept
+      { return r.fresh && r.reachable; }
+
+   auto select(request const& req) -> connection&;
+   void start_run(config const& cfg, replication_config const& rcfg, logger l);
+   void run_primary();
+   void on_info(system::error_code ec);
+   void on_ping(std::size_t i, system::error_code ec, std::chrono::steady_clock::duration rtt);
+
+   executor_type ex_;
+   asio::ssl::context::method method_;
+   std::size_t max_read_size_;
+   connection primary_;
+   std::vector<std::unique_ptr<replica>> replicas_;
+
+   config cfg_;
+   replication_config rcfg_;
+   logger logger_;
+   bool running_ = false;
+   asio::steady_timer timer_;
+   request info_req_;
+   request ping_req_;
+   generic_response info_resp_;
+   std::size_t next_ = 0;
+};
+
+} // boost::redis
+
+#endif // BOOST_REDIS_REPLICATED_CONNECTION_HPP
@@ -7,12 +7,15 @@
 #ifndef BOOST_REDIS_REQUEST_HPP
 #define BOOST_REDIS_REQUEST_HPP
 
+#include <boost/redis/command.hpp>
 #include <boost/redis/resp3/type.hpp>
 #include <boost/redis/resp3/serialization.hpp>
 
+#include <chrono>
 #include <string>
 #include <tuple>
 #include <algorithm>
+#include <utility>
 
 // NOTE: For some commands like hset it would be a good idea to assert
 // the value type is a pair.
@@ -21,6 +24,9 @@ namespace boost::redis {
 
 namespace detail{
 auto has_response(std::string_view cmd) -> bool;
+
+// Compares command names ignoring the case of ASCII letters.
+auto iequals(std::string_view a, std::string_view b) noexcept -> bool;
 }
 
 /** \brief Creates Redis requests.
@@ -41,7 +47,10 @@ auto has_response(std::string_view cmd) -> bool;
  *
  *  \remarks
  *
- *  Uses a std::string for internal storage.
+ *  Uses a std::string for internal storage. To avoid allocating it
+ *  for every request the storage can be passed to the constructor
+ *  and taken back with `release_buffer`, for example from a
+ *  per-thread pool of buffers.
  */
 class request {
 public:
@@ -74,6 +83,16 @@ public:
        * send `HELLO` and authenticate before other commands are sent.
        */
       bool hello_with_priority = true;
+
+      /** \brief Time after which `boost::redis::connection::async_exec`
+       * completes with `boost::redis::error::request_timeout`, counted
+       * from the call. Zero means no timeout.
+       *
+       * A request that times out after being written completes
+       * without waiting for its responses, which are discarded when
+       * they arrive, so the connection stays usable.
+       */
+      std::chrono::steady_clock::duration timeout = std::chrono::steady_clock::duration::zero();
    };
 
    /** \brief Constructor
@@ -81,7 +100,7 @@ public:
     *  \param cfg Configuration options.
     */
     explicit
-    request(config cfg = config{true, false, true, true})
+    request(config cfg = config{true, false, true, true, {}})
     : cfg_{cfg} {}
 
     //// Returns the number of responses expected for this request.
@@ -107,6 +126,31 @@ public:
       has_hello_priority_ = false;
    }
 
+   /** \brief Clears the request and uses `buffer` as storage.
+    *
+    *  The content of `buffer` is discarded but its memory is kept,
+    *  e.g. to reuse the storage returned by `release_buffer`.
+    *
+    *  \param buffer Storage for the payload.
+    */
+   void set_buffer(std::string buffer)
+   {
+      clear();
+      payload_ = std::move(buffer);
+      payload_.clear();
+   }
+
+   /** \brief Clears the request and returns its storage.
+    *
+    *  The returned string is empty but keeps the allocated memory,
+    *  so that it can be passed to `set_buffer` of another request.
+    */
+   auto release_buffer() -> std::string
+   {
+      clear();
+      return std::move(payload_);
+   }
+
    /// Calls std::string::reserve on the internal storage.
    void reserve(std::size_t new_cap = 0)
       { payload_.reserve(new_cap); }
@@ -153,6 +197,34 @@ public:
       check_cmd(cmd);
    }
 
+   /** @brief Appends a new command to the end of the request.
+    *
+    *  Same as the overload above but the array header and the
+    *  command name have been serialized at compile time, see
+    *  `boost::redis::static_command`. For example
+    *
+    *  \code
+    *  constexpr auto set_cmd = make_command<2>("SET");
+    *
+    *  request req;
+    *  req.push(set_cmd, "key", "some string");
+    *  \endcode
+    *
+    *  \param cmd The command.
+    *  \param args Command arguments, their number must match the command.
+    */
+   template <std::size_t N, std::size_t Args, class... Ts>
+   void push(static_command<N, Args> const& cmd, Ts const&... args)
+   {
+      static_assert(sizeof...(Ts) == Args, "Wrong number of arguments for the command.");
+
+      auto const prefix = cmd.get_prefix();
+      payload_.append(std::cbegin(prefix), std::cend(prefix));
+      resp3::add_bulk(payload_, std::tie(std::forward<Ts const&>(args)...));
+
+      check_cmd(cmd.get_name());
+   }
+
    /** @brief Appends a new command to the end of the request.
     *  
     *  This overload is useful for commands that have a key and have a
@@ -0,0 +1,130 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_RESP3_FLAT_TREE_HPP
+#define BOOST_REDIS_RESP3_FLAT_TREE_HPP
+
+#include <boost/redis/resp3/node.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace boost::redis::resp3 {
+
+/** @brief A response tree stored in a single buffer.
+ *  @ingroup high-level-api
+ *
+ *  Like `std::vector<resp3::node>` this class contains the
+ *  pre-order view of the response tree, but instead of allocating a
+ *  `std::string` for each node, the node values are copied
+ *  back-to-back into a single buffer and the nodes hold a
+ *  `std::string_view` into it. This results in one allocation for the
+ *  data and one for the nodes, both amortized, regardless of the
+ *  number of elements in the response.
+ *
+ *  The views remain valid until the tree is modified or
+ *  destroyed. Copies and moves point their views to their own
+ *  buffer. Calling `clear` releases the data but keeps the
+ *  allocated memory so it can be reused by the next response.
+ */
+class flat_tree {
+public:
+   /// The node type.
+   using node_type = basic_node<std::string_view>;
+
+   /// Iterator type.
+   using const_iterator = std::vector<node_type>::const_iterator;
+
+   /// Default constructor.
+   flat_tree() = default;
+
+   /// Copy constructor.
+   flat_tree(flat_tree const& other);
+
+   /// Move constructor.
+   flat_tree(flat_tree&& other) noexcept;
+
+   /// Copy assignment.
+   auto operator=(flat_tree const& other) -> flat_tree&;
+
+   /// Move assignment.
+   auto operator=(flat_tree&& other) noexcept -> flat_tree&;
+
+   /// Appends a node to the tree copying its value into the buffer.
+   void push_back(node_type const& nd);
+
+   /// Removes all nodes preserving allocated memory.
+   void clear() noexcept;
+
+   /// Reserves memory for nodes and data.
+   void reserve(std::size_t nodes, std::size_t bytes);
+
+   /// Returns the nodes.
+   [[nodiscard]] auto get_nodes() const noexcept -> std::vector<node_type> const&
+      { return nodes_; }
+
+   /// Returns the number of bytes used by the node values.
+   [[nodiscard]] auto get_data_size() const noexcept -> std::size_t
+      { return data_.size(); }
+
+   /// Returns an iterator to the first node.
+   [[nodiscard]] auto begin() const noexcept { return std::cbegin(nodes_); }
+
+   /// Returns an iterator past the last node.
+   [[nodiscard]] auto end() const noexcept { return std::cend(nodes_); }
+
+   /// Returns the number of nodes.
+   [[nodiscard]] auto size() const noexcept { return nodes_.size(); }
+
+   /// Returns true if the tree has no nodes.
+   [[nodiscard]] auto empty() const noexcept { return nodes_.empty(); }
+
+   /// Returns the first node.
+   [[nodiscard]] auto front() const -> node_type const& { return nodes_.front(); }
+
+   /// Returns the last node.
+   [[nodiscard]] auto back() const -> node_type const& { return nodes_.back(); }
+
+   /// Returns the node at position i.
+   [[nodiscard]] auto at(std::size_t i) const -> node_type const& { return nodes_.at(i); }
+
+   /// Returns the node at position i.
+   [[nodiscard]] auto operator[](std::size_t i) const -> node_type const& { return nodes_[i]; }
+
+private:
+   // Reallocates the data buffer and points the existing views to
+   // it.
+   void grow(std::size_t capacity);
+
+   // Points the views to data_. Values are stored back-to-back in
+   // node order, so offsets are recomputed from the value sizes.
+   void rebase() noexcept;
+
+   std::string data_;
+   std::vector<node_type> nodes_;
+};
+
+/** @brief Compares two trees for equality.
+ *  @relates flat_tree
+ *
+ *  @param a Left hand side tree.
+ *  @param b Right hand side tree.
+ */
+bool operator==(flat_tree const& a, flat_tree const& b);
+
+/** @brief Compares two trees for difference.
+ *  @relates flat_tree
+ *
+ *  @param a Left hand side tree.
+ *  @param b Right hand side tree.
+ */
+inline bool operator!=(flat_tree const& a, flat_tree const& b)
+   { return !(a == b); }
+
+} // boost::redis::resp3
+
+#endif // BOOST_REDIS_RESP3_FLAT_TREE_HPP
@@ -0,0 +1,106 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/resp3/flat_tree.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace boost::redis::resp3 {
+
+flat_tree::flat_tree(flat_tree const& other)
+: data_{other.data_}
+, nodes_{other.nodes_}
+{
+   rebase();
+}
+
+flat_tree::flat_tree(flat_tree&& other) noexcept
+: data_{std::move(other.data_)}
+, nodes_{std::move(other.nodes_)}
+{
+   // Small buffers are copied by the string move.
+   rebase();
+   other.clear();
+}
+
+auto flat_tree::operator=(flat_tree const& other) -> flat_tree&
+{
+   if (this != &other) {
+      data_ = other.data_;
+      nodes_ = other.nodes_;
+      rebase();
+   }
+
+   return *this;
+}
+
+auto flat_tree::operator=(flat_tree&& other) noexcept -> flat_tree&
+{
+   if (this != &other) {
+      data_ = std::move(other.data_);
+      nodes_ = std::move(other.nodes_);
+      rebase();
+      other.clear();
+   }
+
+   return *this;
+}
+
+void flat_tree::push_back(node_type const& nd)
+{
+   auto const n = std::size(nd.value);
+   auto const offset = std::size(data_);
+   if (offset + n > data_.capacity())
+      grow((std::max)(2 * data_.capacity(), offset + n));
+
+   data_.append(std::cbegin(nd.value), std::cend(nd.value));
+
+   std::string_view value;
+   if (n != 0)
+      value = std::string_view{data_}.substr(offset, n);
+
+   nodes_.push_back({nd.data_type, nd.aggregate_size, nd.depth, value});
+}
+
+void flat_tree::grow(std::size_t capacity)
+{
+   data_.reserve(capacity);
+   rebase();
+}
+
+void flat_tree::rebase() noexcept
+{
+   std::string_view const view{data_};
+   std::size_t offset = 0;
+   for (auto& e: nodes_) {
+      auto const n = std::size(e.value);
+      if (n != 0)
+         e.value = view.substr(offset, n);
+      offset += n;
+   }
+}
+
+void flat_tree::clear() noexcept
+{
+   data_.clear();
+   nodes_.clear();
+}
+
+void flat_tree::reserve(std::size_t nodes, std::size_t bytes)
+{
+   if (bytes > data_.capacity())
+      grow(bytes);
+
+   nodes_.reserve(nodes);
+}
+
+bool operator==(flat_tree const& a, flat_tree const& b)
+{
+   return a.get_nodes() == b.get_nodes();
+}
+
+} // boost::redis::resp3
@@ -0,0 +1,36 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/resp3/node_queue.hpp>
+
+#include <stdexcept>
+
+namespace boost::redis::resp3 {
+
+void node_queue::pop_front() noexcept
+{
+   if (messages_.empty())
+      return;
+
+   nodes_.pop_front(messages_.front());
+   messages_.pop_front();
+}
+
+void node_queue::clear() noexcept
+{
+   nodes_.clear();
+   messages_.clear();
+}
+
+auto node_queue::at(std::size_t i) const -> node_type const&
+{
+   if (i >= nodes_.size())
+      throw std::out_of_range("node_queue::at");
+
+   return nodes_[i];
+}
+
+} // boost::redis::resp3
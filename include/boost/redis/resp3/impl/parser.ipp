@@ -6,17 +6,117 @@
 
 #include <boost/redis/resp3/parser.hpp>
 #include <boost/redis/error.hpp>
+#include <boost/redis/detail/number.hpp>
 #include <boost/assert.hpp>
+#include <boost/core/bit.hpp>
 
-#include <charconv>
+#include <algorithm>
+#include <cstring>
 #include <limits>
 
+#if !defined(BOOST_REDIS_NO_SIMD)
+#  if defined(__AVX2__)
+#    include <immintrin.h>
+#    define BOOST_REDIS_SEPARATOR_AVX2
+#  elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define BOOST_REDIS_SEPARATOR_SSE2
+#  endif
+#endif
+
 namespace boost::redis::resp3 {
+namespace detail
+{
+
+char const* find_separator_scalar(char const* first, char const* last) noexcept
+{
+   while (first != last) {
+      auto const* p = static_cast<char const*>(std::memchr(first, '\r', static_cast<std::size_t>(last - first)));
+      if (p == nullptr || p + 1 == last)
+         return last;
+
+      if (p[1] == '\n')
+         return p;
+
+      first = p + 1;
+   }
+
+   return last;
+}
+
+#if defined(BOOST_REDIS_SEPARATOR_AVX2) || defined(BOOST_REDIS_SEPARATOR_SSE2)
+// Number of blocks scanned with SIMD instructions before falling
+// back to memchr.
+constexpr int simd_blocks = 4;
+#endif
+
+#if defined(BOOST_REDIS_SEPARATOR_AVX2)
+char const* find_separator_simd(char const* first, char const* last) noexcept
+{
+   // Compares each block with '\r' and the block shifted by one with
+   // '\n', the separator is where both match. The +1 load needs one
+   // byte past the block. Headers are short, so only the first blocks
+   // are scanned here, longer lines are left to memchr which is
+   // faster on long runs.
+   auto const cr = _mm256_set1_epi8('\r');
+   auto const lf = _mm256_set1_epi8('\n');
+   for (int i = 0; i < simd_blocks && last - first > 32; ++i) {
+      auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+      auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first + 1));
+      auto const mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+         _mm256_and_si256(_mm256_cmpeq_epi8(a, cr), _mm256_cmpeq_epi8(b, lf))));
+      if (mask != 0)
+         return first + core::countr_zero(mask);
+
+      first += 32;
+   }
+
+   return find_separator_scalar(first, last);
+}
+#elif defined(BOOST_REDIS_SEPARATOR_SSE2)
+char const* find_separator_simd(char const* first, char const* last) noexcept
+{
+   // See the AVX2 version above.
+   auto const cr = _mm_set1_epi8('\r');
+   auto const lf = _mm_set1_epi8('\n');
+   for (int i = 0; i < simd_blocks && last - first > 16; ++i) {
+      auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+      auto const b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first + 1));
+      auto const mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+         _mm_and_si128(_mm_cmpeq_epi8(a, cr), _mm_cmpeq_epi8(b, lf))));
+      if (mask != 0)
+         return first + core::countr_zero(mask);
+
+      first += 16;
+   }
+
+   return find_separator_scalar(first, last);
+}
+#else
+char const* find_separator_simd(char const* first, char const* last) noexcept
+{
+   return find_separator_scalar(first, last);
+}
+#endif
+
+auto find_separator(std::string_view view, std::size_t pos) noexcept -> std::size_t
+{
+   if (pos >= std::size(view))
+      return std::string_view::npos;
+
+   auto const* last = view.data() + std::size(view);
+   auto const* p = find_separator_simd(view.data() + pos, last);
+   if (p == last)
+      return std::string_view::npos;
+
+   return static_cast<std::size_t>(p - view.data());
+}
+
+} // detail
 
 void to_int(int_type& i, std::string_view sv, system::error_code& ec)
 {
-   auto const res = std::from_chars(sv.data(), sv.data() + std::size(sv), i);
-   if (res.ec != std::errc())
+   if (!redis::detail::parse_integer(i, sv))
       ec = error::not_a_number;
 }
 
@@ -32,9 +132,16 @@ void parser::reset()
    bulk_length_ = (std::numeric_limits<unsigned long>::max)();
    bulk_ = type::invalid;
    consumed_ = 0;
+   scanned_ = 0;
    sizes_[0] = 2; // The sentinel must be more than 1.
 }
 
+void parser::skip_bulk() noexcept
+{
+   BOOST_ASSERT(bulk_expected());
+   bulk_length_ = 0;
+}
+
 std::size_t
 parser::get_suggested_buffer_growth(std::size_t hint) const noexcept
 {
@@ -75,9 +182,15 @@ parser::consume(std::string_view view, system::error_code& ec) noexcept -> parse
    switch (bulk_) {
       case type::invalid:
       {
-         auto const pos = view.find(sep, consumed_);
-         if (pos == std::string::npos)
+         auto const pos = detail::find_separator(view, (std::max)(consumed_, scanned_));
+         if (pos == std::string::npos) {
+            // A '\r' in the last byte might be followed by a '\n' in the
+            // next read, so it has to be scanned again.
+            if (std::size(view) > consumed_)
+               scanned_ = std::size(view) - 1;
+
             return {}; // Needs more data to proceeed.
+         }
 
          auto const t = to_type(view.at(consumed_));
          auto const content = view.substr(consumed_ + 1, pos - 1 - consumed_);
@@ -7,25 +7,24 @@
 #include <boost/redis/resp3/serialization.hpp>
 #include <boost/redis/resp3/parser.hpp>
 
+#include <charconv>
+
 namespace boost::redis::resp3 {
 
 void boost_redis_to_bulk(std::string& payload, std::string_view data)
 {
-   auto const str = std::to_string(data.size());
-
-   payload += to_code(type::blob_string);
-   payload.append(std::cbegin(str), std::cend(str));
-   payload += parser::sep;
+   add_header(payload, type::blob_string, data.size());
    payload.append(std::cbegin(data), std::cend(data));
    payload += parser::sep;
 }
 
 void add_header(std::string& payload, type t, std::size_t size)
 {
-   auto const str = std::to_string(size);
+   char buffer[24];
+   auto const res = std::to_chars(buffer, buffer + sizeof buffer, size);
 
    payload += to_code(t);
-   payload.append(std::cbegin(str), std::cend(str));
+   payload.append(buffer, res.ptr);
    payload += parser::sep;
 }
 
@@ -9,6 +9,13 @@
 
 #include <boost/redis/resp3/type.hpp>
 
+#include <string>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define BOOST_REDIS_HAS_MEMORY_RESOURCE
+#endif
+
 namespace boost::redis::resp3 {
 
 /** \brief A node in the response tree.
@@ -59,6 +66,17 @@ auto operator==(basic_node<String> const& a, basic_node<String> const& b)
  */
 using node = basic_node<std::string>;
 
+#ifdef BOOST_REDIS_HAS_MEMORY_RESOURCE
+namespace pmr {
+
+/** @brief A node whose value uses a polymorphic allocator.
+ *  @ingroup high-level-api
+ */
+using node = basic_node<std::pmr::string>;
+
+} // pmr
+#endif // BOOST_REDIS_HAS_MEMORY_RESOURCE
+
 } // boost::redis::resp3
 
 #endif // BOOST_REDIS_RESP3_NODE_HPP
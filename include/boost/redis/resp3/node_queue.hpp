@@ -0,0 +1,92 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_RESP3_NODE_QUEUE_HPP
+#define BOOST_REDIS_RESP3_NODE_QUEUE_HPP
+
+#include <boost/redis/resp3/node.hpp>
+#include <boost/redis/detail/ring_buffer.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace boost::redis::resp3 {
+
+/** @brief A queue of messages in pre-order.
+ *  @ingroup high-level-api
+ *
+ *  Like `std::vector<resp3::node>` this class contains the
+ *  pre-order view of the messages, but the nodes are stored in a
+ *  circular buffer that keeps track of where each message starts, so
+ *  that the oldest message can be removed in constant time with
+ *  `pop_front`. Removed nodes are reused by the messages that follow,
+ *  including the memory held by their values, so that once the
+ *  queue has grown to its working size no further allocations are
+ *  needed.
+ *
+ *  The elements are indexed from the front of the queue.
+ */
+class node_queue {
+public:
+   /// The node type.
+   using node_type = node;
+
+   /// Appends a node, nodes with depth zero start a new message.
+   template <class String>
+   void push_back(basic_node<String> const& nd)
+   {
+      if (nd.depth == 0 || messages_.empty())
+         messages_.push_back() = 0;
+
+      auto& e = nodes_.push_back();
+      e.data_type = nd.data_type;
+      e.aggregate_size = nd.aggregate_size;
+      e.depth = nd.depth;
+      e.value.assign(std::data(nd.value), std::size(nd.value));
+      messages_.back() += 1;
+   }
+
+   /// Removes the nodes of the first message.
+   void pop_front() noexcept;
+
+   /// Removes all nodes preserving allocated memory.
+   void clear() noexcept;
+
+   /// Returns the number of nodes.
+   [[nodiscard]] auto size() const noexcept { return nodes_.size(); }
+
+   /// Returns true if the queue has no nodes.
+   [[nodiscard]] auto empty() const noexcept { return nodes_.empty(); }
+
+   /// Returns the number of messages.
+   [[nodiscard]] auto get_messages() const noexcept { return messages_.size(); }
+
+   /// Returns the number of nodes of the first message.
+   [[nodiscard]] auto get_front_size() const noexcept -> std::size_t
+      { return messages_.empty() ? 0 : messages_.front(); }
+
+   /// Returns the first node.
+   [[nodiscard]] auto front() const -> node_type const& { return nodes_.front(); }
+
+   /// Returns the last node.
+   [[nodiscard]] auto back() const -> node_type const& { return nodes_.back(); }
+
+   /// Returns the node at position i.
+   [[nodiscard]] auto at(std::size_t i) const -> node_type const&;
+
+   /// Returns the node at position i.
+   [[nodiscard]] auto operator[](std::size_t i) const -> node_type const& { return nodes_[i]; }
+
+private:
+   redis::detail::ring_buffer<node_type> nodes_;
+
+   // The number of nodes of each message.
+   redis::detail::ring_buffer<std::size_t> messages_;
+};
+
+} // boost::redis::resp3
+
+#endif // BOOST_REDIS_RESP3_NODE_QUEUE_HPP
@@ -13,11 +13,26 @@
 #include <string_view>
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 namespace boost::redis::resp3 {
 
 using int_type = std::uint64_t;
 
+namespace detail
+{
+
+/* Returns the position of the first separator i.e. "\r\n" at or
+ * after pos or std::string_view::npos if there is none.
+ *
+ * Uses AVX2 or SSE2 when the target supports it and falls back to
+ * memchr otherwise. Define BOOST_REDIS_NO_SIMD to force the scalar
+ * version.
+ */
+auto find_separator(std::string_view view, std::size_t pos) noexcept -> std::size_t;
+
+} // detail
+
 class parser {
 public:
    using node_type = basic_node<std::string_view>;
@@ -47,6 +62,11 @@ private:
    // The number of bytes consumed from the buffer.
    std::size_t consumed_;
 
+   // Position up to which the buffer has already been scanned for a
+   // separator without success. Avoids scanning the same bytes again
+   // when a header arrives in multiple reads.
+   std::size_t scanned_;
+
    // Returns the number of bytes that have been consumed.
    auto consume_impl(type t, std::string_view elem, system::error_code& ec) -> node_type;
 
@@ -72,6 +92,28 @@ public:
    auto consume(std::string_view view, system::error_code& ec) noexcept -> result;
 
    void reset();
+
+   // The type of the bulk expected in the next read or type::invalid
+   // if none is expected.
+   [[nodiscard]]
+   auto get_bulk_type() const noexcept -> type
+      { return bulk_; }
+
+   // The length of the bulk expected in the next read.
+   [[nodiscard]]
+   auto get_bulk_length() const noexcept -> std::size_t
+      { return bulk_length_; }
+
+   // The depth of the next element.
+   [[nodiscard]]
+   auto get_depth() const noexcept -> std::size_t
+      { return depth_; }
+
+   // Informs the parser that the content of the expected bulk has
+   // been consumed by other means e.g. read directly into the
+   // response. Only the separator is expected afterwards and the
+   // resulting node has an empty value.
+   void skip_bulk() noexcept;
 };
 
 // Returns false if more data is needed. If true is returned the
@@ -101,6 +143,50 @@ parse(
    return true;
 }
 
+/* Batch version of parse.
+ *
+ * Collects the nodes of the message in nodes and passes them to the
+ * adapter in a single call i.e. adapter(nodes, ec) instead of once
+ * per node. When more data is needed the nodes collected so far are
+ * passed to the adapter before returning false, since they are views
+ * into msg and its storage might be invalidated when more data is
+ * read. The vector is cleared on entry so its capacity can be reused
+ * across calls.
+ */
+template <class Adapter>
+bool
+parse(
+   resp3::parser& p,
+   std::string_view const& msg,
+   std::vector<parser::node_type>& nodes,
+   Adapter& adapter,
+   system::error_code& ec)
+{
+   nodes.clear();
+
+   bool done = true;
+   while (!p.done()) {
+      auto const res = p.consume(msg, ec);
+      if (ec)
+         return true;
+
+      if (!res) {
+         done = false;
+         break;
+      }
+
+      nodes.push_back(res.value());
+   }
+
+   if (!nodes.empty()) {
+      adapter(nodes, ec);
+      if (ec)
+         return true;
+   }
+
+   return done;
+}
+
 } // boost::redis::resp3
 
 #endif // BOOST_REDIS_RESP3_PARSER_HPP
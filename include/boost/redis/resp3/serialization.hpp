@@ -12,8 +12,10 @@
 #include <boost/throw_exception.hpp>
 #include <boost/redis/resp3/parser.hpp>
 
+#include <charconv>
 #include <string>
 #include <tuple>
+#include <type_traits>
 
 // NOTE: Consider detecting tuples in the type in the parameter pack
 // to calculate the header size correctly.
@@ -44,8 +46,16 @@ void boost_redis_to_bulk(std::string& payload, std::string_view data);
 template <class T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
 void boost_redis_to_bulk(std::string& payload, T n)
 {
-   auto const s = std::to_string(n);
-   boost::redis::resp3::boost_redis_to_bulk(payload, std::string_view{s});
+   // Large enough for any 64-bit integer.
+   char buffer[24];
+
+   std::to_chars_result res;
+   if constexpr (std::is_same_v<T, bool>)
+      res = std::to_chars(buffer, buffer + sizeof buffer, static_cast<int>(n));
+   else
+      res = std::to_chars(buffer, buffer + sizeof buffer, n);
+
+   boost::redis::resp3::boost_redis_to_bulk(payload, std::string_view(buffer, res.ptr - buffer));
 }
 
 template <class T>
@@ -8,6 +8,8 @@
 #define BOOST_REDIS_RESPONSE_HPP
 
 #include <boost/redis/resp3/node.hpp>
+#include <boost/redis/resp3/flat_tree.hpp>
+#include <boost/redis/resp3/node_queue.hpp>
 #include <boost/redis/adapter/result.hpp>
 #include <boost/system.hpp>
 
@@ -34,6 +36,53 @@ using response = std::tuple<adapter::result<Ts>...>;
  */
 using generic_response = adapter::result<std::vector<resp3::node>>;
 
+/** @brief A generic response that stores the data in a single buffer
+ *  @ingroup high-level-api
+ *
+ *  Same as `generic_response` but the node values are stored
+ *  back-to-back in a buffer owned by the response instead of one
+ *  `std::string` per node, see `resp3::flat_tree`. Call `value().clear()`
+ *  to reuse the memory across requests.
+ */
+using generic_flat_response = adapter::result<resp3::flat_tree>;
+
+/** @brief A generic response that can be consumed in constant time
+ *  @ingroup high-level-api
+ *
+ *  Same as `generic_response` but the nodes are stored in a
+ *  `resp3::node_queue`, which keeps track of where each message
+ *  starts. `consume_one` then removes the first message in O(1)
+ *  and the memory of the removed nodes is reused by the following
+ *  messages. Meant to be used with `set_receive_response` to buffer
+ *  server pushes.
+ */
+using generic_queue_response = adapter::result<resp3::node_queue>;
+
+#ifdef BOOST_REDIS_HAS_MEMORY_RESOURCE
+namespace pmr {
+
+/** @brief A generic response that uses a polymorphic allocator
+ *  @ingroup high-level-api
+ *
+ *  Same as `boost::redis::generic_response` but the vector and the
+ *  node values allocate from the memory resource the vector has been
+ *  constructed with, for example
+ *
+ *  @code
+ *  std::pmr::monotonic_buffer_resource mr;
+ *  pmr::generic_response resp{std::pmr::vector<resp3::pmr::node>{&mr}};
+ *  co_await conn->async_exec(req, resp, asio::deferred);
+ *  @endcode
+ *
+ *  All memory is then released at once by the resource. Containers
+ *  in a `boost::redis::response` e.g. `std::pmr::map` work the same
+ *  way.
+ */
+using generic_response = adapter::result<std::pmr::vector<resp3::pmr::node>>;
+
+} // pmr
+#endif // BOOST_REDIS_HAS_MEMORY_RESOURCE
+
 /** @brief Consume on response from a generic response
  *
  *  This function rotates the elements so that the start of the next
@@ -67,14 +116,24 @@ using generic_response = adapter::result<std::vector<resp3::node>>;
  * Given that this function rotates elements, it won't be very
  * efficient for responses with a large number of elements. It was
  * introduced mainly to deal with buffers server pushes as shown in
- * the cpp20_subscriber.cpp example. In the future queue-like
- * responses might be introduced to consume in O(1) operations. 
+ * the cpp20_subscriber.cpp example. Use a `generic_queue_response`
+ * to consume in O(1) operations.
  */
 void consume_one(generic_response& r, system::error_code& ec);
 
 /// Throwing overload of `consume_one`.
 void consume_one(generic_response& r);
 
+/** @brief Consume on response from a generic queue response
+ *
+ *  Removes the first message in constant time, see
+ *  `generic_queue_response`.
+ */
+void consume_one(generic_queue_response& r, system::error_code& ec);
+
+/// Throwing overload of `consume_one`.
+void consume_one(generic_queue_response& r);
+
 } // boost::redis
 
 #endif // BOOST_REDIS_RESPONSE_HPP
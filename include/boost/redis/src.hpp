@@ -7,9 +7,22 @@
 #include <boost/redis/impl/error.ipp>
 #include <boost/redis/impl/logger.ipp>
 #include <boost/redis/impl/request.ipp>
+#include <boost/redis/impl/cluster.ipp>
+#include <boost/redis/impl/replication.ipp>
 #include <boost/redis/impl/ignore.ipp>
 #include <boost/redis/impl/connection.ipp>
+#include <boost/redis/impl/connection_pool.ipp>
+#include <boost/redis/impl/cluster_connection.ipp>
+#include <boost/redis/impl/replicated_connection.ipp>
+#include <boost/redis/impl/client_cache.ipp>
+#include <boost/redis/impl/cached_connection.ipp>
+#include <boost/redis/impl/subscriber.ipp>
 #include <boost/redis/impl/response.ipp>
+#include <boost/redis/impl/number.ipp>
+#include <boost/redis/impl/metrics.ipp>
+#include <boost/redis/impl/timer_wheel.ipp>
 #include <boost/redis/resp3/impl/type.ipp>
 #include <boost/redis/resp3/impl/parser.ipp>
+#include <boost/redis/resp3/impl/flat_tree.ipp>
+#include <boost/redis/resp3/impl/node_queue.ipp>
 #include <boost/redis/resp3/impl/serialization.ipp>
@@ -0,0 +1,265 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#ifndef BOOST_REDIS_SUBSCRIBER_HPP
+#define BOOST_REDIS_SUBSCRIBER_HPP
+
+#include <boost/redis/connection.hpp>
+#include <boost/redis/config.hpp>
+#include <boost/redis/error.hpp>
+#include <boost/redis/ignore.hpp>
+#include <boost/redis/logger.hpp>
+#include <boost/redis/operation.hpp>
+#include <boost/redis/pubsub_message.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/detail/pubsub.hpp>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/coroutine.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace boost::redis {
+namespace detail
+{
+
+template <class Conn>
+struct subscriber_exec_op {
+   Conn* conn_;
+   std::unique_ptr<request> req_;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t n = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro)
+      {
+         BOOST_ASIO_CORO_YIELD
+         conn_->conn_.async_exec(*req_, ignore, std::move(self));
+         self.complete(ec, n);
+      }
+   }
+};
+
+template <class Conn>
+struct subscriber_run_op {
+   Conn* conn_;
+   asio::coroutine coro{};
+
+   template <class Self>
+   void operator()(Self& self, system::error_code ec = {}, std::size_t = 0)
+   {
+      BOOST_ASIO_CORO_REENTER (coro)
+      {
+         conn_->run_connection();
+
+         for (;;) {
+            for (;;) {
+               // Drains the pushes that have already been read
+               // without suspending.
+               conn_->conn_.receive(ec);
+               if (ec == error::sync_receive_push_failed) {
+                  ec = {};
+                  BOOST_ASIO_CORO_YIELD
+                  conn_->conn_.async_receive(std::move(self));
+               }
+
+               if (ec)
+                  break;
+
+               conn_->dispatch();
+            }
+
+            // Receiving is cancelled when the connection is lost. The
+            // subscriptions are then sent again and will be written
+            // as soon as the connection is reestablished. The ones
+            // made before the first connection are written by their
+            // own requests.
+            if (!conn_->conn_.will_reconnect())
+               break;
+
+            if (conn_->make_resubscribe_request()) {
+               BOOST_ASIO_CORO_YIELD
+               conn_->conn_.async_exec(conn_->resubscribe_req_, ignore, std::move(self));
+               if (ec)
+                  break;
+            }
+         }
+
+         self.complete(asio::error::operation_aborted);
+      }
+   }
+};
+
+} // detail
+
+/** @brief A connection dedicated to Pub/Sub.
+ *  @ingroup high-level-api
+ *
+ *  Parses `message`, `pmessage` and `smessage` pushes directly into
+ *  `boost::redis::pubsub_message` objects and dispatches them to the
+ *  handler registered for their channel, or pattern for `pmessage`,
+ *  without going through a `boost::redis::generic_response`.
+ *  Subscriptions are tracked and sent again after a reconnection.
+ *
+ *  Handlers are called from the run operation and must not block.
+ *  The message passed to them is only valid during the call and its
+ *  strings are reused for subsequent messages.
+ *
+ *  All other pushes e.g. subscription confirmations are discarded,
+ *  the connection should therefore not be used for other commands.
+ */
+class subscriber {
+public:
+   /// Executor type.
+   using executor_type = asio::any_io_executor;
+
+   /// Handler type.
+   using handler_type = std::function<void(pubsub_message const&)>;
+
+   /** @brief Constructor
+    *
+    *  @param ex Executor on which the connection runs.
+    *  @param method SSL method.
+    *  @param max_read_size See `boost::redis::basic_connection`.
+    */
+   explicit
+   subscriber(
+      executor_type ex,
+      asio::ssl::context::method method = asio::ssl::context::tls_client,
+      std::size_t max_read_size = (std::numeric_limits<std::size_t>::max)());
+
+   /// Returns the underlying executor.
+   executor_type get_executor() noexcept
+      { return conn_.get_executor(); }
+
+   /// Returns the underlying connection.
+   auto next_layer() noexcept -> connection&
+      { return conn_; }
+
+   /** @brief Sets the handler of a channel or pattern.
+    *
+    *  Passing an empty handler removes it.
+    */
+   void set_handler(std::string_view channel, handler_type handler);
+
+   /// Sets the handler of messages whose channel has no handler.
+   void set_default_handler(handler_type handler)
+      { default_handler_ = std::move(handler); }
+
+   /// Returns the number of messages dispatched to a handler.
+   auto get_messages_dispatched() const noexcept
+      { return dispatched_; }
+
+   /// Returns the number of messages for which no handler was found.
+   auto get_messages_dropped() const noexcept
+      { return dropped_; }
+
+   /** @brief Starts the connection.
+    *
+    *  Calls `boost::redis::basic_connection::async_run` and
+    *  dispatches messages until the connection is cancelled.
+    *
+    *  @param cfg Configuration parameters.
+    *  @param l Logger object, converted to `logger`, see `boost::redis::basic_logger`.
+    *  @param token Completion token with signature `void(system::error_code)`.
+    */
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto
+   async_run(
+      config const& cfg = {},
+      logger l = logger{},
+      CompletionToken token = CompletionToken{})
+   {
+      start_run(cfg, l);
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code)
+         >(detail::subscriber_run_op<subscriber>{this}, token, conn_);
+   }
+
+   /** @brief Subscribes to channels.
+    *
+    *  @param channels The channels.
+    *  @param token Completion token with signature `void(system::error_code, std::size_t)`.
+    */
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto async_subscribe(std::vector<std::string> const& channels, CompletionToken token = CompletionToken{})
+      { return async_update("SUBSCRIBE", channels, std::move(token)); }
+
+   /// Subscribes to patterns, see `async_subscribe`.
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto async_psubscribe(std::vector<std::string> const& patterns, CompletionToken token = CompletionToken{})
+      { return async_update("PSUBSCRIBE", patterns, std::move(token)); }
+
+   /// Subscribes to shard channels, see `async_subscribe`.
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto async_ssubscribe(std::vector<std::string> const& channels, CompletionToken token = CompletionToken{})
+      { return async_update("SSUBSCRIBE", channels, std::move(token)); }
+
+   /// Unsubscribes from channels, or all channels if empty, see `async_subscribe`.
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto async_unsubscribe(std::vector<std::string> const& channels, CompletionToken token = CompletionToken{})
+      { return async_update("UNSUBSCRIBE", channels, std::move(token)); }
+
+   /// Unsubscribes from patterns, or all patterns if empty, see `async_subscribe`.
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto async_punsubscribe(std::vector<std::string> const& patterns, CompletionToken token = CompletionToken{})
+      { return async_update("PUNSUBSCRIBE", patterns, std::move(token)); }
+
+   /// Unsubscribes from shard channels, or all shard channels if empty, see `async_subscribe`.
+   template <class CompletionToken = asio::default_completion_token_t<executor_type>>
+   auto async_sunsubscribe(std::vector<std::string> const& channels, CompletionToken token = CompletionToken{})
+      { return async_update("SUNSUBSCRIBE", channels, std::move(token)); }
+
+   /// Calls `boost::redis::basic_connection::cancel`.
+   void cancel(operation op = operation::all)
+      { conn_.cancel(op); }
+
+private:
+   template <class> friend struct detail::subscriber_exec_op;
+   template <class> friend struct detail::subscriber_run_op;
+
+   template <class CompletionToken>
+   auto async_update(std::string_view cmd, std::vector<std::string> const& channels, CompletionToken token)
+   {
+      return asio::async_compose
+         < CompletionToken
+         , void(system::error_code, std::size_t)
+         >(detail::subscriber_exec_op<subscriber>{this, make_request(cmd, channels)}, token, conn_);
+   }
+
+   void start_run(config const& cfg, logger l);
+   void run_connection();
+   auto make_request(std::string_view cmd, std::vector<std::string> const& channels) -> std::unique_ptr<request>;
+   bool make_resubscribe_request();
+   void dispatch();
+
+   connection conn_;
+   config cfg_;
+   logger logger_;
+   detail::pubsub_queue queue_;
+   request resubscribe_req_;
+   std::set<std::string> channels_;
+   std::set<std::string> patterns_;
+   std::set<std::string> shard_channels_;
+   std::unordered_map<std::string, handler_type> handlers_;
+   handler_type default_handler_;
+   std::size_t dispatched_ = 0;
+   std::size_t dropped_ = 0;
+};
+
+} // boost::redis
+
+#endif // BOOST_REDIS_SUBSCRIBER_HPP
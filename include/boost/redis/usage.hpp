@@ -7,6 +7,9 @@
 #ifndef BOOST_REDIS_USAGE_HPP
 #define BOOST_REDIS_USAGE_HPP
 
+#include <chrono>
+#include <cstddef>
+
 namespace boost::redis
 {
 
@@ -36,6 +39,39 @@ struct usage {
 
    /// Number of push-bytes received.
    std::size_t push_bytes_received = 0;
+
+   /// Largest number of bytes held by the read buffer.
+   std::size_t read_buffer_max_size = 0;
+
+   /// Largest capacity of the read buffer.
+   std::size_t read_buffer_max_capacity = 0;
+
+   /// Current capacity of the read buffer.
+   std::size_t read_buffer_capacity = 0;
+
+   /// Number of times the read buffer memory has been released, see `config::read_buffer_shrink_threshold`.
+   std::size_t read_buffer_shrinks = 0;
+
+   /// Number of times the connection with the server has been established.
+   std::size_t connections = 0;
+
+   /// Number of pushes discarded, see `config::push_overflow`.
+   std::size_t pushes_dropped = 0;
+
+   /// Number of pushes queued beyond `config::push_channel_capacity` with `push_policy::spill`.
+   std::size_t pushes_spilled = 0;
+
+   /// Current number of pushes waiting to be received.
+   std::size_t pushes_queued = 0;
+
+   /// Number of `PING`s sent by the health checker, see `config::health_check`.
+   std::size_t health_check_pings = 0;
+
+   /// Round trip time of the last health check `PING`.
+   std::chrono::steady_clock::duration health_check_rtt{0};
+
+   /// Smoothed round trip time of the health check `PING`s, an exponential moving average with weight 1/8 as in TCP.
+   std::chrono::steady_clock::duration health_check_srtt{0};
 };
 
 } // boost::redis
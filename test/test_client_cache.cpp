@@ -0,0 +1,132 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/client_cache.hpp>
+#include <boost/redis/response.hpp>
+#include <boost/redis/detail/raw_replies.hpp>
+
+#define BOOST_TEST_MODULE client_cache
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+#include <tuple>
+
+namespace resp3 = boost::redis::resp3;
+using boost::redis::client_cache;
+using boost::redis::response;
+using boost::redis::detail::deliver_replies;
+
+auto make_reply(std::string const& value) -> client_cache::reply_type
+{
+   return {resp3::node{resp3::type::blob_string, 1, 0, value}};
+}
+
+BOOST_AUTO_TEST_CASE(get_and_put)
+{
+   client_cache cache{10, 1};
+   client_cache::reply_type reply;
+
+   BOOST_TEST(!cache.get("key", "GET key", reply));
+   BOOST_TEST(cache.put("key", "GET key", make_reply("value"), cache.get_epoch("key")));
+   BOOST_TEST(cache.get("key", "GET key", reply));
+   BOOST_CHECK_EQUAL(reply.front().value, "value");
+
+   // Overwrites the existing entry.
+   BOOST_TEST(cache.put("key", "GET key", make_reply("other"), cache.get_epoch("key")));
+   BOOST_TEST(cache.get("key", "GET key", reply));
+   BOOST_CHECK_EQUAL(reply.front().value, "other");
+
+   BOOST_CHECK_EQUAL(cache.size(), 1u);
+   BOOST_CHECK_EQUAL(cache.get_hits(), 2u);
+   BOOST_CHECK_EQUAL(cache.get_misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(lru_eviction)
+{
+   client_cache cache{2, 1};
+   client_cache::reply_type reply;
+
+   cache.put("a", "GET a", make_reply("1"), cache.get_epoch("a"));
+   cache.put("b", "GET b", make_reply("2"), cache.get_epoch("b"));
+
+   // Makes b the least recently used entry.
+   BOOST_TEST(cache.get("a", "GET a", reply));
+
+   cache.put("c", "GET c", make_reply("3"), cache.get_epoch("c"));
+   BOOST_CHECK_EQUAL(cache.size(), 2u);
+   BOOST_TEST(cache.get("a", "GET a", reply));
+   BOOST_TEST(!cache.get("b", "GET b", reply));
+   BOOST_TEST(cache.get("c", "GET c", reply));
+}
+
+BOOST_AUTO_TEST_CASE(invalidate_key)
+{
+   client_cache cache{10, 4};
+   client_cache::reply_type reply;
+
+   cache.put("h", "HGET h f1", make_reply("1"), cache.get_epoch("h"));
+   cache.put("h", "HGET h f2", make_reply("2"), cache.get_epoch("h"));
+   cache.put("k", "GET k", make_reply("3"), cache.get_epoch("k"));
+
+   // Removes all entries of the key.
+   cache.invalidate("h");
+   BOOST_TEST(!cache.get("h", "HGET h f1", reply));
+   BOOST_TEST(!cache.get("h", "HGET h f2", reply));
+   BOOST_TEST(cache.get("k", "GET k", reply));
+   BOOST_CHECK_EQUAL(cache.size(), 1u);
+
+   // Keys that are not in the cache are ignored.
+   cache.invalidate("missing");
+   BOOST_CHECK_EQUAL(cache.size(), 1u);
+   BOOST_CHECK_EQUAL(cache.get_invalidations(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(stale_put)
+{
+   client_cache cache{10, 1};
+   client_cache::reply_type reply;
+
+   // The key is invalidated while the command is in flight.
+   auto const epoch = cache.get_epoch("key");
+   cache.invalidate("key");
+   BOOST_TEST(!cache.put("key", "GET key", make_reply("old"), epoch));
+   BOOST_TEST(!cache.get("key", "GET key", reply));
+
+   auto const epoch2 = cache.get_epoch("key");
+   cache.clear();
+   BOOST_TEST(!cache.put("key", "GET key", make_reply("old"), epoch2));
+   BOOST_CHECK_EQUAL(cache.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(clear)
+{
+   client_cache cache{100, 8};
+
+   for (int i = 0; i < 20; ++i) {
+      auto const key = std::to_string(i);
+      cache.put(key, "GET " + key, make_reply(key), cache.get_epoch(key));
+   }
+
+   BOOST_CHECK_EQUAL(cache.size(), 20u);
+   cache.clear();
+   BOOST_CHECK_EQUAL(cache.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(deliver_cached_replies)
+{
+   std::vector<client_cache::reply_type> replies
+      { make_reply("value")
+      , {resp3::node{resp3::type::number, 1, 0, "42"}}
+      };
+
+   response<std::string, int> resp;
+   boost::system::error_code ec;
+   deliver_replies(replies, resp, ec);
+
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "value");
+   BOOST_CHECK_EQUAL(std::get<1>(resp).value(), 42);
+}
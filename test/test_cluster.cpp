@@ -0,0 +1,262 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/cluster.hpp>
+#include <boost/redis/adapter/adapt.hpp>
+#include <boost/redis/response.hpp>
+#include <boost/redis/resp3/parser.hpp>
+
+#define BOOST_TEST_MODULE cluster
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+namespace resp3 = boost::redis::resp3;
+using boost::redis::adapter::adapt2;
+using boost::redis::detail::cluster_command;
+using boost::redis::detail::cluster_slot_range;
+using boost::redis::detail::cluster_unit;
+using boost::redis::request;
+using boost::redis::generic_response;
+using boost::system::error_code;
+
+BOOST_AUTO_TEST_CASE(crc16)
+{
+   // Check value of CRC16-CCITT (XMODEM).
+   BOOST_CHECK_EQUAL(boost::redis::detail::crc16("123456789"), 0x31C3);
+   BOOST_CHECK_EQUAL(boost::redis::detail::crc16(""), 0);
+}
+
+BOOST_AUTO_TEST_CASE(hash_slot)
+{
+   using boost::redis::detail::get_hash_slot;
+
+   BOOST_CHECK_EQUAL(get_hash_slot("foo"), 12182u);
+   BOOST_CHECK_EQUAL(get_hash_slot("bar"), 5061u);
+
+   // Hash tags.
+   BOOST_CHECK_EQUAL(get_hash_slot("{user1000}.following"), get_hash_slot("user1000"));
+   BOOST_CHECK_EQUAL(get_hash_slot("{user1000}.followers"), get_hash_slot("user1000"));
+   BOOST_CHECK_EQUAL(get_hash_slot("foo{{bar}}zap"), get_hash_slot("{bar"));
+   BOOST_CHECK_EQUAL(get_hash_slot("foo{bar}{zap}"), get_hash_slot("bar"));
+
+   // Empty hash tags are ignored.
+   BOOST_CHECK_EQUAL(get_hash_slot("foo{}{bar}"), boost::redis::detail::crc16("foo{}{bar}") % 16384u);
+}
+
+BOOST_AUTO_TEST_CASE(commands_and_units)
+{
+   request req;
+   req.push("PING");
+   req.push("SET", "{a}1", "value");
+   req.push("MULTI");
+   req.push("INCR", "{b}1");
+   req.push("INCR", "{b}2");
+   req.push("EXEC");
+   req.push("EVAL", "return 1", 1, "c");
+   req.push("xread", "COUNT", 2, "STREAMS", "s", "0");
+
+   std::vector<cluster_command> cmds;
+   error_code ec;
+   boost::redis::detail::parse_commands(req.payload(), cmds, ec);
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(cmds.size(), 8u);
+   BOOST_CHECK_EQUAL(cmds.at(1).name, "SET");
+   BOOST_CHECK_EQUAL(cmds.at(1).args.size(), 2u);
+   BOOST_CHECK_EQUAL(cmds.at(1).args.at(1), "value");
+
+   using boost::redis::detail::get_command_key;
+   BOOST_TEST(!get_command_key(cmds.at(0)).has_value());
+   BOOST_CHECK_EQUAL(get_command_key(cmds.at(1)).value(), "{a}1");
+   BOOST_CHECK_EQUAL(get_command_key(cmds.at(6)).value(), "c");
+   BOOST_CHECK_EQUAL(get_command_key(cmds.at(7)).value(), "s");
+
+   std::vector<cluster_unit> units;
+   boost::redis::detail::make_units(cmds, units);
+   BOOST_CHECK_EQUAL(units.size(), 5u);
+
+   // The transaction is a single unit routed by its first key.
+   BOOST_CHECK_EQUAL(units.at(2).first, 2u);
+   BOOST_CHECK_EQUAL(units.at(2).last, 6u);
+   BOOST_CHECK_EQUAL(units.at(2).slot.value(), boost::redis::detail::get_hash_slot("b"));
+   BOOST_TEST(!units.at(0).slot.has_value());
+
+   // Commands are serialized back without changes.
+   request sub;
+   for (auto const& unit: units)
+      boost::redis::detail::append_unit(sub, cmds, unit);
+
+   BOOST_CHECK_EQUAL(sub.payload(), req.payload());
+   BOOST_CHECK_EQUAL(sub.get_expected_responses(), req.get_expected_responses());
+}
+
+BOOST_AUTO_TEST_CASE(cluster_slots)
+{
+   std::string const wire =
+      "*2\r\n"
+         "*4\r\n"
+            ":0\r\n"
+            ":5460\r\n"
+            "*3\r\n$9\r\n127.0.0.1\r\n:30001\r\n$2\r\nid\r\n"
+            "*4\r\n$9\r\n127.0.0.1\r\n:30004\r\n$2\r\nid\r\n%1\r\n$8\r\nhostname\r\n$4\r\nhost\r\n"
+         "*3\r\n"
+            ":5461\r\n"
+            ":16383\r\n"
+            "*3\r\n$0\r\n\r\n:30002\r\n$2\r\nid\r\n";
+
+   generic_response resp;
+   error_code ec;
+   resp3::parser p;
+   auto adapter = adapt2(resp);
+   resp3::parse(p, wire, adapter, ec);
+   BOOST_TEST(!ec);
+
+   std::vector<cluster_slot_range> ranges;
+   boost::redis::detail::parse_cluster_slots(resp.value(), "seed", ranges, ec);
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(ranges.size(), 2u);
+
+   BOOST_CHECK_EQUAL(ranges.at(0).begin, 0u);
+   BOOST_CHECK_EQUAL(ranges.at(0).end, 5460u);
+   BOOST_CHECK_EQUAL(ranges.at(0).primary.host, "127.0.0.1");
+   BOOST_CHECK_EQUAL(ranges.at(0).primary.port, "30001");
+   BOOST_CHECK_EQUAL(ranges.at(0).replicas.size(), 1u);
+   BOOST_CHECK_EQUAL(ranges.at(0).replicas.at(0).port, "30004");
+
+   // An empty host refers to the node that sent the response.
+   BOOST_CHECK_EQUAL(ranges.at(1).begin, 5461u);
+   BOOST_CHECK_EQUAL(ranges.at(1).end, 16383u);
+   BOOST_CHECK_EQUAL(ranges.at(1).primary.host, "seed");
+   BOOST_CHECK_EQUAL(ranges.at(1).primary.port, "30002");
+   BOOST_TEST(ranges.at(1).replicas.empty());
+}
+
+BOOST_AUTO_TEST_CASE(cluster_slots_invalid)
+{
+   std::vector<resp3::node> nodes
+      { {resp3::type::array, 1, 0, {}}
+      , {resp3::type::array, 3, 1, {}}
+      , {resp3::type::number, 1, 2, "10"}
+      , {resp3::type::number, 1, 2, "20000"}
+      , {resp3::type::array, 2, 2, {}}
+      , {resp3::type::blob_string, 1, 3, "127.0.0.1"}
+      , {resp3::type::number, 1, 3, "30001"}
+      };
+
+   std::vector<cluster_slot_range> ranges;
+   error_code ec;
+   boost::redis::detail::parse_cluster_slots(nodes, "seed", ranges, ec);
+   BOOST_CHECK_EQUAL(ec, boost::redis::error::invalid_cluster_slots);
+}
+
+BOOST_AUTO_TEST_CASE(redirection)
+{
+   using boost::redis::detail::parse_redirection;
+
+   auto const moved = parse_redirection("MOVED 3999 127.0.0.1:6381", "seed");
+   BOOST_TEST(moved.has_value());
+   BOOST_TEST(!moved->ask);
+   BOOST_CHECK_EQUAL(moved->slot, 3999u);
+   BOOST_CHECK_EQUAL(moved->addr.host, "127.0.0.1");
+   BOOST_CHECK_EQUAL(moved->addr.port, "6381");
+
+   auto const ask = parse_redirection("ASK 3999 ::1:6381", "seed");
+   BOOST_TEST(ask.has_value());
+   BOOST_TEST(ask->ask);
+   BOOST_CHECK_EQUAL(ask->addr.host, "::1");
+   BOOST_CHECK_EQUAL(ask->addr.port, "6381");
+
+   auto const unknown_host = parse_redirection("MOVED 1 :6381", "seed");
+   BOOST_TEST(unknown_host.has_value());
+   BOOST_CHECK_EQUAL(unknown_host->addr.host, "seed");
+
+   BOOST_TEST(!parse_redirection("ERR unknown command", "seed").has_value());
+   BOOST_TEST(!parse_redirection("MOVED 20000 127.0.0.1:6381", "seed").has_value());
+   BOOST_TEST(!parse_redirection("MOVED 1 127.0.0.1", "seed").has_value());
+}
+
+// Drives the split and merge of a request through a MOVED and an ASK
+// redirection, as cluster_connection::async_exec does.
+BOOST_AUTO_TEST_CASE(exec_redirections)
+{
+   using boost::redis::address;
+   using boost::redis::response;
+   using boost::redis::detail::cluster_exec_state;
+   using boost::redis::detail::cluster_router;
+
+   auto const reply = [](resp3::type t, std::string v) {
+      return std::vector<resp3::node>{{t, 1, 0, std::move(v)}};
+   };
+
+   cluster_router router;
+   router.set_seed({"seed", "6379"});
+   router.set_slots({
+      {0, 8191, {"a", "7000"}, {}},
+      {8192, 16383, {"b", "7001"}, {}},
+   });
+   BOOST_CHECK_EQUAL(router.get_nodes(), 3u);
+
+   // foo is in slot 12182 and bar in 5061.
+   request req;
+   req.push("PING");
+   req.push("GET", "foo");
+   req.push("GET", "bar");
+
+   error_code ec;
+   cluster_exec_state st;
+   router.init_exec(req, st, ec);
+   BOOST_TEST(!ec);
+
+   // First round, one subrequest per node.
+   router.make_subrequests(req, st);
+   BOOST_REQUIRE_EQUAL(st.subs.size(), 3u);
+   BOOST_CHECK_EQUAL(st.subs[0].node, 0u);
+   BOOST_CHECK_EQUAL(st.subs[1].node, 2u);
+   BOOST_CHECK_EQUAL(st.subs[2].node, 1u);
+
+   st.subs[0].replies.values = {reply(resp3::type::simple_string, "PONG")};
+   st.subs[1].replies.values = {reply(resp3::type::simple_error, "MOVED 12182 c:7002")};
+   st.subs[2].replies.values = {reply(resp3::type::simple_error, "ASK 5061 b:7001")};
+
+   BOOST_TEST(router.on_subrequests(st, true));
+   BOOST_CHECK_EQUAL(st.pending.size(), 2u);
+   BOOST_CHECK_EQUAL(router.get_nodes(), 4u);
+   BOOST_CHECK_EQUAL(router.get_slot_node(12182), 3u);
+   BOOST_CHECK_EQUAL(router.get_slot_node(5061), 1u);
+
+   // Second round, the ASK is preceded by ASKING.
+   router.make_subrequests(req, st);
+   BOOST_REQUIRE_EQUAL(st.subs.size(), 2u);
+   BOOST_CHECK_EQUAL(st.subs[0].node, 3u);
+   BOOST_CHECK_EQUAL(st.subs[1].node, 2u);
+   BOOST_CHECK_EQUAL(st.subs[1].req.get_expected_responses(), 2u);
+   BOOST_TEST(st.subs[1].req.payload().find("ASKING") != std::string::npos);
+
+   st.subs[0].replies.values = {reply(resp3::type::blob_string, "foo-value")};
+   st.subs[1].replies.values = {reply(resp3::type::simple_string, "OK"), reply(resp3::type::blob_string, "bar-value")};
+
+   BOOST_TEST(!router.on_subrequests(st, true));
+   BOOST_TEST(st.pending.empty());
+
+   // The replies are merged in the original order.
+   response<std::string, std::string, std::string> resp;
+   boost::redis::detail::deliver_replies(st.replies, resp, ec);
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "PONG");
+   BOOST_CHECK_EQUAL(std::get<1>(resp).value(), "foo-value");
+   BOOST_CHECK_EQUAL(std::get<2>(resp).value(), "bar-value");
+
+   // Redirections are not followed in the last round.
+   router.init_exec(req, st, ec);
+   router.make_subrequests(req, st);
+   for (auto& sub: st.subs)
+      sub.replies.values = {reply(resp3::type::simple_error, "MOVED 12182 d:7003")};
+
+   BOOST_TEST(!router.on_subrequests(st, false));
+   BOOST_TEST(st.pending.empty());
+   BOOST_CHECK_EQUAL(router.get_nodes(), 4u);
+}
@@ -0,0 +1,108 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/cached_connection.hpp>
+#define BOOST_TEST_MODULE conn-cached
+#include <boost/test/included/unit_test.hpp>
+#include <iostream>
+#include <string>
+
+namespace net = boost::asio;
+using boost::redis::cached_connection;
+using boost::redis::request;
+using boost::redis::response;
+using boost::redis::ignore;
+
+BOOST_AUTO_TEST_CASE(cacheable_commands)
+{
+   using boost::redis::detail::is_cacheable_command;
+
+   BOOST_TEST(is_cacheable_command("GET"));
+   BOOST_TEST(is_cacheable_command("hget"));
+   BOOST_TEST(is_cacheable_command("ZSCORE"));
+   BOOST_TEST(!is_cacheable_command("SET"));
+   BOOST_TEST(!is_cacheable_command("TTL"));
+   BOOST_TEST(!is_cacheable_command("SRANDMEMBER"));
+   BOOST_TEST(!is_cacheable_command(""));
+}
+
+BOOST_AUTO_TEST_CASE(second_read_is_served_from_cache)
+{
+   net::io_context ioc;
+   cached_connection conn{ioc.get_executor()};
+
+   request write;
+   write.push("SET", "cached-key", "value");
+
+   request read;
+   read.push("GET", "cached-key");
+
+   response<std::string> resp1;
+   response<std::string> resp2;
+   std::size_t read_size = 1;
+
+   conn.async_exec(write, ignore, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      conn.async_exec(read, resp1, [&](auto ec2, auto) {
+         BOOST_TEST(!ec2);
+         conn.async_exec(read, resp2, [&](auto ec3, auto n) {
+            BOOST_TEST(!ec3);
+            read_size = n;
+            conn.cancel();
+         });
+      });
+   });
+
+   conn.async_run({}, {}, [](auto ec) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+   });
+
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(std::get<0>(resp1).value(), "value");
+   BOOST_CHECK_EQUAL(std::get<0>(resp2).value(), "value");
+   BOOST_CHECK_EQUAL(read_size, 0u);
+   BOOST_CHECK_EQUAL(conn.get_cache().get_hits(), 1u);
+}
+
+// The replies to commands in a transaction are QUEUED, whatever the
+// case of MULTI.
+BOOST_AUTO_TEST_CASE(transaction_is_not_cached)
+{
+   net::io_context ioc;
+   cached_connection conn{ioc.get_executor()};
+
+   request write;
+   write.push("SET", "cached-multi-key", "value");
+
+   request trans;
+   trans.push("Multi");
+   trans.push("GET", "cached-multi-key");
+   trans.push("Exec");
+
+   request read;
+   read.push("GET", "cached-multi-key");
+
+   response<std::string> resp;
+
+   conn.async_exec(write, ignore, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      conn.async_exec(trans, ignore, [&](auto ec2, auto) {
+         BOOST_TEST(!ec2);
+         conn.async_exec(read, resp, [&](auto ec3, auto) {
+            BOOST_TEST(!ec3);
+            conn.cancel();
+         });
+      });
+   });
+
+   conn.async_run({}, {}, [](auto) { });
+
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "value");
+   BOOST_CHECK_EQUAL(conn.get_cache().get_hits(), 0u);
+}
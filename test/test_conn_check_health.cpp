@@ -9,6 +9,7 @@
 #include <boost/system/errc.hpp>
 #define BOOST_TEST_MODULE check-health
 #include <boost/test/included/unit_test.hpp>
+#include <functional>
 #include <iostream>
 #include <thread>
 #include "common.hpp"
@@ -127,3 +128,51 @@ BOOST_AUTO_TEST_CASE(check_health)
    std::this_thread::sleep_for(std::chrono::seconds{10});
 }
 
+
+// With health_check_policy::idle PINGs are only sent when the
+// connection has been idle for an interval.
+BOOST_AUTO_TEST_CASE(check_health_idle)
+{
+   net::io_context ioc;
+   connection conn{ioc};
+
+   config cfg;
+   cfg.health_check_interval = std::chrono::milliseconds{200};
+   cfg.health_check = redis::health_check_policy::idle;
+   conn.async_run(cfg, {}, [](auto) { });
+
+   request req;
+   req.push("PING", "busy");
+
+   // Keeps the connection busy for a second and idle for another.
+   auto const busy_until = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+   std::size_t busy_pings = 0;
+   net::steady_timer timer{ioc};
+
+   std::function<void(error_code, std::size_t)> on_exec = [&](error_code ec, std::size_t)
+   {
+      BOOST_TEST(!ec);
+      if (std::chrono::steady_clock::now() < busy_until) {
+         conn.async_exec(req, ignore, on_exec);
+         return;
+      }
+
+      busy_pings = conn.get_usage().health_check_pings;
+      timer.expires_after(std::chrono::seconds{1});
+      timer.async_wait([&](auto) {
+         conn.cancel(operation::reconnection);
+         conn.cancel(operation::run);
+      });
+   };
+
+   conn.async_exec(req, ignore, on_exec);
+   ioc.run();
+
+   // At most the PING sent when the connection is established.
+   BOOST_TEST(busy_pings <= 1u);
+
+   auto const u = conn.get_usage();
+   BOOST_TEST(u.health_check_pings >= busy_pings + 3);
+   BOOST_TEST(u.health_check_rtt.count() > 0);
+   BOOST_TEST(u.health_check_srtt.count() > 0);
+}
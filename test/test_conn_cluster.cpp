@@ -0,0 +1,66 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/cluster_connection.hpp>
+#define BOOST_TEST_MODULE conn-cluster
+#include <boost/test/included/unit_test.hpp>
+#include <iostream>
+#include <string>
+
+namespace net = boost::asio;
+using boost::redis::cluster_connection;
+using boost::redis::request;
+using boost::redis::response;
+using boost::redis::ignore;
+using boost::redis::ignore_t;
+using boost::redis::operation;
+
+// The test server has no cluster support, in which case all
+// commands are sent to the node in the config and the pipeline must
+// go through the split and merge unchanged.
+BOOST_AUTO_TEST_CASE(pipeline_without_cluster_support)
+{
+   net::io_context ioc;
+   cluster_connection conn{ioc.get_executor()};
+
+   request req;
+   req.push("PING", "a");
+   req.push("SET", "{cluster}1", "value1");
+   req.push("MULTI");
+   req.push("SET", "{cluster}2", "value2");
+   req.push("GET", "{cluster}2");
+   req.push("EXEC");
+   req.push("GET", "{cluster}1");
+
+   response<
+      std::string,
+      ignore_t,
+      ignore_t,
+      ignore_t,
+      ignore_t,
+      response<std::string, std::string>,
+      std::string
+   > resp;
+
+   bool exec_finished = false;
+   conn.async_exec(req, resp, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      exec_finished = true;
+      conn.cancel();
+   });
+
+   conn.async_run({}, {}, [](auto ec) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+   });
+
+   ioc.run();
+
+   BOOST_TEST(exec_finished);
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "a");
+   BOOST_CHECK_EQUAL(std::get<1>(std::get<5>(resp).value()).value(), "value2");
+   BOOST_CHECK_EQUAL(std::get<6>(resp).value(), "value1");
+   BOOST_CHECK_EQUAL(conn.get_nodes(), 1u);
+}
@@ -37,7 +37,15 @@ std::ostream& operator<<(std::ostream& os, usage const& u)
       << "Responses received: " << u.responses_received << "\n"
       << "Pushes received: " << u.pushes_received << "\n"
       << "Response bytes received: " << u.response_bytes_received << "\n"
-      << "Push bytes received: " << u.push_bytes_received;
+      << "Push bytes received: " << u.push_bytes_received << "\n"
+      << "Read buffer max size: " << u.read_buffer_max_size << "\n"
+      << "Read buffer max capacity: " << u.read_buffer_max_capacity << "\n"
+      << "Read buffer capacity: " << u.read_buffer_capacity << "\n"
+      << "Read buffer shrinks: " << u.read_buffer_shrinks << "\n"
+      << "Connections: " << u.connections << "\n"
+      << "Pushes dropped: " << u.pushes_dropped << "\n"
+      << "Pushes spilled: " << u.pushes_spilled << "\n"
+      << "Pushes queued: " << u.pushes_queued;
 
    return os;
 }
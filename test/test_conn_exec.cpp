@@ -5,10 +5,17 @@
  */
 
 #include <boost/redis/connection.hpp>
+#include <boost/asio/deferred.hpp>
 #include <boost/system/errc.hpp>
 #define BOOST_TEST_MODULE conn-exec
 #include <boost/test/included/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
 #include "common.hpp"
 
 // TODO: Test whether HELLO won't be inserted passt commands that have
@@ -22,8 +29,12 @@ using boost::redis::request;
 using boost::redis::response;
 using boost::redis::generic_response;
 using boost::redis::ignore;
+using boost::redis::ignore_t;
 using boost::redis::operation;
 using boost::redis::config;
+using boost::redis::basic_connection;
+using boost::redis::no_metrics;
+using boost::redis::latency_metrics;
 
 // Sends three requests where one of them has a hello with a priority
 // set, which means it should be executed first.
@@ -154,3 +165,239 @@ BOOST_AUTO_TEST_CASE(correct_database)
    BOOST_CHECK_EQUAL(cfg.database_index.value(), index);
 }
 
+
+// Mixes payloads below and above the copy threshold so that the
+// writer has to interleave copied and referenced buffers.
+BOOST_AUTO_TEST_CASE(large_payloads)
+{
+   config cfg;
+   cfg.write_copy_threshold = 1024;
+
+   std::string const small(10, 'a');
+   std::string const large(100 * 1024, 'b');
+
+   request req1;
+   req1.push("SET", "large-payloads-key", large);
+   req1.push("PING", small);
+
+   request req2;
+   req2.push("PING", small);
+   req2.push("GET", "large-payloads-key");
+
+   response<std::string, std::string> resp1;
+   response<std::string, std::string> resp2;
+
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   conn->async_exec(req1, resp1, [&](auto ec, auto){
+      BOOST_TEST(!ec);
+   });
+
+   conn->async_exec(req2, resp2, [&](auto ec, auto){
+      BOOST_TEST(!ec);
+      conn->cancel();
+   });
+
+   conn->async_run(cfg, {}, [](auto){ });
+
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(std::get<1>(resp1).value(), small);
+   BOOST_CHECK_EQUAL(std::get<0>(resp2).value(), small);
+   BOOST_CHECK_EQUAL(std::get<1>(resp2).value(), large);
+}
+
+// Reads a response larger than the shrink threshold and checks the
+// read buffer memory is released afterwards.
+BOOST_AUTO_TEST_CASE(read_buffer_shrink)
+{
+   config cfg;
+   cfg.read_buffer_initial_capacity = 512;
+   cfg.read_buffer_shrink_threshold = 64 * 1024;
+   cfg.direct_read_threshold = (std::numeric_limits<std::size_t>::max)();
+
+   std::string const large(1024 * 1024, 'c');
+
+   request req;
+   req.push("SET", "read-buffer-shrink-key", large);
+   req.push("GET", "read-buffer-shrink-key");
+
+   response<ignore_t, std::string> resp;
+
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   conn->async_exec(req, resp, [&](auto ec, auto){
+      BOOST_TEST(!ec);
+      conn->cancel();
+   });
+
+   conn->async_run(cfg, {}, [](auto){ });
+
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(std::get<1>(resp).value(), large);
+
+   auto const u = conn->get_usage();
+   BOOST_TEST(u.read_buffer_max_size >= large.size());
+   BOOST_TEST(u.read_buffer_max_capacity >= large.size());
+   BOOST_TEST(u.read_buffer_capacity <= cfg.read_buffer_shrink_threshold);
+   BOOST_TEST(u.read_buffer_shrinks != 0u);
+}
+
+// Reads a large blob directly into the response.
+BOOST_AUTO_TEST_CASE(direct_read)
+{
+   config cfg;
+   cfg.direct_read_threshold = 1024;
+
+   std::string const large(4 * 1024 * 1024, 'd');
+
+   request req;
+   req.push("SET", "direct-read-key", large);
+   req.push("GET", "direct-read-key");
+   req.push("GET", "direct-read-key");
+   req.push("PING", "after");
+
+   response<ignore_t, std::string, std::optional<std::string>, std::string> resp;
+
+   // Appended to, as when the blob is read through the parser.
+   std::get<1>(resp).value() = "prefix-";
+
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   conn->async_exec(req, resp, [&](auto ec, auto n){
+      BOOST_TEST(!ec);
+      BOOST_TEST(n > 2 * large.size());
+      conn->cancel();
+   });
+
+   conn->async_run(cfg, {}, [](auto){ });
+
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(std::get<1>(resp).value(), "prefix-" + large);
+   BOOST_CHECK_EQUAL(std::get<2>(resp).value().value(), large);
+   BOOST_CHECK_EQUAL(std::get<3>(resp).value(), "after");
+   BOOST_TEST(conn->get_usage().read_buffer_max_size < large.size());
+}
+
+// Records the events of the request lifecycle.
+struct recording_observer {
+   struct entry {
+      std::string name;
+      std::uint64_t id;
+      request const* req;
+   };
+
+   std::vector<entry> events;
+
+   void on_event(boost::redis::enqueue_event const& ev)
+      { events.push_back({"enqueue", ev.id, ev.req}); }
+   void on_event(boost::redis::stage_event const& ev)
+      { events.push_back({"stage", ev.id, nullptr}); }
+   void on_event(boost::redis::write_event const& ev)
+      { events.push_back({"write", ev.id, nullptr}); }
+   void on_event(boost::redis::first_byte_event const& ev)
+      { events.push_back({"first_byte", ev.id, nullptr}); }
+   void on_event(boost::redis::parse_event const& ev)
+      { events.push_back({"parse" + std::to_string(ev.index), ev.id, nullptr}); }
+   void on_event(boost::redis::completion_event const& ev)
+      { events.push_back({ev.ec ? "error" : "completion", ev.id, nullptr}); }
+};
+
+BOOST_AUTO_TEST_CASE(observer_events)
+{
+   request req;
+   req.push("PING", "one");
+   req.push("PING", "two");
+
+   net::io_context ioc;
+   using conn_type = basic_connection<net::any_io_executor, no_metrics, recording_observer>;
+   auto conn = std::make_shared<conn_type>(ioc.get_executor());
+
+   conn->async_exec(req, ignore, [&](auto ec, auto){
+      BOOST_TEST(!ec);
+      conn->cancel(operation::run);
+      conn->cancel(operation::reconnection);
+   });
+
+   conn->async_run({}, {}, [](auto){ });
+
+   ioc.run();
+
+   // The HELLO sent by async_run has its own events.
+   auto const& events = conn->get_observer().events;
+   auto const it = std::find_if(std::cbegin(events), std::cend(events), [&](auto const& e) { return e.req == &req; });
+   BOOST_REQUIRE(it != std::cend(events));
+
+   std::vector<std::string> names;
+   for (auto const& e: events) {
+      if (e.id == it->id)
+         names.push_back(e.name);
+   }
+
+   std::vector<std::string> const expected
+      {"enqueue", "stage", "write", "first_byte", "parse0", "parse1", "completion"};
+
+   BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(names), std::cend(names), std::cbegin(expected), std::cend(expected));
+}
+
+// An operation that is never launched leaves no trace.
+BOOST_AUTO_TEST_CASE(exec_not_launched)
+{
+   request req;
+   req.push("PING");
+
+   net::io_context ioc;
+   basic_connection<net::any_io_executor, latency_metrics, recording_observer> conn{ioc.get_executor()};
+
+   {
+      auto op = conn.async_exec(req, ignore, net::deferred);
+   }
+
+   BOOST_CHECK_EQUAL(conn.get_metrics().snapshot().max_pending_requests, 0u);
+   BOOST_TEST(conn.get_observer().events.empty());
+}
+
+// A request that times out after being written completes with
+// request_timeout and its response is discarded, the next request on
+// the same connection gets its own response.
+BOOST_AUTO_TEST_CASE(request_timeout)
+{
+   request::config cfg;
+   cfg.timeout = std::chrono::milliseconds{100};
+
+   request req1{cfg};
+   req1.push("BLPOP", "request-timeout-key", 1);
+
+   request req2;
+   req2.push("PING", "after");
+
+   response<std::string> resp2;
+
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   bool finished = false;
+   conn->async_exec(req1, ignore, [&](auto ec, auto){
+      BOOST_CHECK_EQUAL(ec, boost::redis::error::request_timeout);
+
+      conn->async_exec(req2, resp2, [&](auto ec, auto){
+         BOOST_TEST(!ec);
+         // The timeout did not cost a reconnection.
+         BOOST_CHECK_EQUAL(conn->get_usage().connections, 1u);
+         finished = true;
+         conn->cancel();
+      });
+   });
+
+   conn->async_run({}, {}, [](auto){ });
+
+   ioc.run();
+
+   BOOST_TEST(finished);
+   BOOST_CHECK_EQUAL(std::get<0>(resp2).value(), "after");
+}
@@ -0,0 +1,105 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/connection_pool.hpp>
+#include <boost/asio/thread_pool.hpp>
+#define BOOST_TEST_MODULE conn-pool
+#include <boost/test/included/unit_test.hpp>
+#include <atomic>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace net = boost::asio;
+using boost::redis::connection_pool;
+using boost::redis::request;
+using boost::redis::response;
+using boost::redis::ignore;
+using boost::redis::operation;
+using boost::redis::config;
+
+// Boost.Test assertions are not thread-safe, so the handlers only
+// store their results, which are checked after joining the threads.
+
+// Requests with the same key must be executed in order even though
+// the pool runs on multiple threads.
+BOOST_AUTO_TEST_CASE(ordering_per_key)
+{
+   net::thread_pool tp{4};
+   connection_pool pool{tp.get_executor(), 4};
+
+   std::promise<void> run_done;
+   pool.async_run({}, {}, [&](auto){ run_done.set_value(); });
+
+   int const n = 1000;
+   std::vector<request> reqs(n);
+   std::vector<response<int>> resps(n);
+   std::vector<boost::system::error_code> ecs(n);
+   std::atomic<int> completed{0};
+   std::promise<void> exec_done;
+
+   for (int i = 0; i < n; ++i) {
+      reqs[i].push("INCR", "conn-pool-key");
+      pool.async_exec("conn-pool-key", reqs[i], resps[i], [&, i](auto ec, auto) {
+         ecs[i] = ec;
+         if (++completed == n)
+            exec_done.set_value();
+      });
+   }
+
+   exec_done.get_future().wait();
+   pool.cancel();
+   run_done.get_future().wait();
+   tp.join();
+
+   for (auto const& ec: ecs)
+      BOOST_TEST(!ec);
+
+   for (int i = 1; i < n; ++i)
+      BOOST_CHECK_EQUAL(std::get<0>(resps[i]).value(), std::get<0>(resps[i - 1]).value() + 1);
+}
+
+BOOST_AUTO_TEST_CASE(least_loaded)
+{
+   net::thread_pool tp{2};
+   connection_pool pool{tp.get_executor(), 3};
+
+   std::promise<void> run_done;
+   pool.async_run({}, {}, [&](auto){ run_done.set_value(); });
+
+   int const n = 300;
+   request req;
+   req.push("PING");
+
+   std::vector<boost::system::error_code> ecs(n);
+   std::atomic<int> completed{0};
+   std::promise<void> exec_done;
+
+   for (int i = 0; i < n; ++i) {
+      pool.async_exec(req, ignore, [&, i](auto ec, auto) {
+         ecs[i] = ec;
+         if (++completed == n)
+            exec_done.set_value();
+      });
+   }
+
+   exec_done.get_future().wait();
+
+   std::vector<std::size_t> outstanding;
+   for (std::size_t i = 0; i < pool.size(); ++i)
+      outstanding.push_back(pool.get_outstanding(i));
+
+   pool.cancel();
+   run_done.get_future().wait();
+   tp.join();
+
+   for (auto const& ec: ecs)
+      BOOST_TEST(!ec);
+
+   for (auto const o: outstanding)
+      BOOST_CHECK_EQUAL(o, 0u);
+}
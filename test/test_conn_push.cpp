@@ -12,6 +12,7 @@
 #include <boost/asio/experimental/as_tuple.hpp>
 #define BOOST_TEST_MODULE conn-push
 #include <boost/test/included/unit_test.hpp>
+#include <functional>
 #include <iostream>
 #include "common.hpp"
 
@@ -157,6 +158,169 @@ BOOST_AUTO_TEST_CASE(push_filtered_out)
    BOOST_CHECK_EQUAL(std::get<2>(resp).value(), "OK");
 }
 
+// Pushes that exceed the capacity must not block the responses.
+BOOST_AUTO_TEST_CASE(push_overflow_drop_newest)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   request req;
+   req.push("SUBSCRIBE", "overflow-channel");
+   req.push("PUBLISH", "overflow-channel", "one");
+   req.push("PUBLISH", "overflow-channel", "two");
+   req.push("PING");
+
+   redis::generic_response push_resp;
+   conn->set_receive_response(push_resp);
+
+   conn->async_exec(req, ignore, [conn](auto ec, auto){
+      BOOST_TEST(!ec);
+      conn->cancel();
+   });
+
+   config cfg;
+   cfg.push_channel_capacity = 1;
+   cfg.push_overflow = redis::push_policy::drop_newest;
+   conn->async_run(cfg, {}, [](auto){ });
+
+   ioc.run();
+
+   // Only the subscribe confirmation has been kept.
+   auto const u = conn->get_usage();
+   BOOST_CHECK_EQUAL(u.pushes_dropped, 2u);
+   BOOST_CHECK_EQUAL(u.pushes_queued, 1u);
+   BOOST_CHECK_EQUAL(push_resp.value().at(1).value, "subscribe");
+}
+
+BOOST_AUTO_TEST_CASE(push_overflow_drop_oldest)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   request req;
+   req.push("SUBSCRIBE", "overflow-channel");
+   req.push("PUBLISH", "overflow-channel", "one");
+   req.push("PUBLISH", "overflow-channel", "two");
+   req.push("PING");
+
+   redis::generic_queue_response push_resp;
+   conn->set_receive_response(push_resp);
+
+   conn->async_exec(req, ignore, [conn](auto ec, auto){
+      BOOST_TEST(!ec);
+      conn->cancel();
+   });
+
+   config cfg;
+   cfg.push_channel_capacity = 1;
+   cfg.push_overflow = redis::push_policy::drop_oldest;
+   conn->async_run(cfg, {}, [](auto){ });
+
+   ioc.run();
+
+   // Only the last message has been kept.
+   auto const u = conn->get_usage();
+   BOOST_CHECK_EQUAL(u.pushes_dropped, 2u);
+   BOOST_CHECK_EQUAL(u.pushes_queued, 1u);
+   BOOST_CHECK_EQUAL(push_resp.value().get_messages(), 1u);
+   BOOST_CHECK_EQUAL(push_resp.value().at(3).value, "two");
+}
+
+// The reader stops until the consumer catches up, so responses
+// arrive only after pushes have been received.
+BOOST_AUTO_TEST_CASE(push_overflow_block)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   request req;
+   req.push("SUBSCRIBE", "overflow-channel");
+   req.push("PUBLISH", "overflow-channel", "one");
+   req.push("PUBLISH", "overflow-channel", "two");
+   req.push("PING");
+
+   redis::generic_response push_resp;
+   conn->set_receive_response(push_resp);
+
+   std::size_t received = 0;
+   std::size_t received_at_exec = 0;
+   std::function<void()> receive = [&]() {
+      conn->async_receive([&](auto ec, auto) {
+         if (ec)
+            return;
+
+         ++received;
+         receive();
+      });
+   };
+
+   conn->async_exec(req, ignore, [&](auto ec, auto){
+      BOOST_TEST(!ec);
+      received_at_exec = received;
+      conn->cancel();
+   });
+
+   config cfg;
+   cfg.push_channel_capacity = 1;
+   cfg.push_overflow = redis::push_policy::block;
+   conn->async_run(cfg, {}, [](auto){ });
+
+   receive();
+   ioc.run();
+
+   // At most one push is waiting when the reader continues.
+   BOOST_TEST(received_at_exec >= 2u);
+   BOOST_CHECK_EQUAL(conn->get_usage().pushes_dropped, 0u);
+   BOOST_CHECK_EQUAL(conn->get_usage().pushes_spilled, 0u);
+}
+
+// Pushes beyond capacity are queued within the spill limit, so
+// responses keep flowing without a consumer.
+BOOST_AUTO_TEST_CASE(push_overflow_spill)
+{
+   net::io_context ioc;
+   auto conn = std::make_shared<connection>(ioc);
+
+   request req;
+   req.push("SUBSCRIBE", "overflow-channel");
+   req.push("PUBLISH", "overflow-channel", "one");
+   req.push("PUBLISH", "overflow-channel", "two");
+   req.push("PING");
+
+   redis::generic_response push_resp;
+   conn->set_receive_response(push_resp);
+
+   std::size_t received = 0;
+   conn->async_exec(req, ignore, [&](auto ec, auto){
+      BOOST_TEST(!ec);
+
+      // All pushes are waiting in the channel.
+      BOOST_CHECK_EQUAL(conn->get_usage().pushes_queued, 3u);
+      for (;;) {
+         error_code ec2;
+         conn->receive(ec2);
+         if (ec2)
+            break;
+         ++received;
+      }
+
+      conn->cancel();
+   });
+
+   config cfg;
+   cfg.push_channel_capacity = 1;
+   cfg.push_overflow = redis::push_policy::spill;
+   conn->async_run(cfg, {}, [](auto){ });
+
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(received, 3u);
+   auto const u = conn->get_usage();
+   BOOST_CHECK_EQUAL(u.pushes_dropped, 0u);
+   BOOST_CHECK_EQUAL(u.pushes_spilled, 2u);
+   BOOST_CHECK_EQUAL(u.pushes_queued, 0u);
+}
+
 #ifdef BOOST_ASIO_HAS_CO_AWAIT
 net::awaitable<void>
 push_consumer1(std::shared_ptr<connection> conn, bool& push_received)
@@ -0,0 +1,54 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/replicated_connection.hpp>
+#define BOOST_TEST_MODULE conn-replicated
+#include <boost/test/included/unit_test.hpp>
+#include <iostream>
+#include <string>
+
+namespace net = boost::asio;
+using boost::redis::replicated_connection;
+using boost::redis::replication_config;
+using boost::redis::read_policy;
+using boost::redis::request;
+using boost::redis::response;
+using boost::redis::ignore_t;
+
+// The test server has no replicas, read-only requests must fall back
+// to the primary.
+BOOST_AUTO_TEST_CASE(reads_without_replicas)
+{
+   net::io_context ioc;
+   replicated_connection conn{ioc.get_executor()};
+
+   request write;
+   write.push("SET", "replicated-key", "value");
+
+   request read;
+   read.push("GET", "replicated-key");
+
+   response<std::string> resp;
+
+   conn.async_exec(write, boost::redis::ignore, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      conn.async_exec(read, resp, [&](auto ec2, auto) {
+         BOOST_TEST(!ec2);
+         conn.cancel();
+      });
+   });
+
+   replication_config rcfg;
+   rcfg.policy = read_policy::least_latency;
+   conn.async_run({}, rcfg, {}, [](auto ec) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+   });
+
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "value");
+   BOOST_CHECK_EQUAL(conn.get_usable_replicas(), 0u);
+}
@@ -0,0 +1,133 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/subscriber.hpp>
+#define BOOST_TEST_MODULE conn-subscriber
+#include <boost/test/included/unit_test.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace net = boost::asio;
+using boost::redis::connection;
+using boost::redis::subscriber;
+using boost::redis::pubsub_message;
+using boost::redis::pubsub_kind;
+using boost::redis::request;
+using boost::redis::ignore;
+using boost::redis::config;
+
+BOOST_AUTO_TEST_CASE(dispatch_to_channel_handlers)
+{
+   net::io_context ioc;
+   subscriber sub{ioc.get_executor()};
+   connection pub{ioc};
+
+   std::string chat_payload;
+   std::string pattern_channel;
+
+   auto const stop = [&]() {
+      if (!chat_payload.empty() && !pattern_channel.empty()) {
+         sub.cancel();
+         pub.cancel();
+      }
+   };
+
+   sub.set_handler("sub-chat", [&](pubsub_message const& msg) {
+      BOOST_TEST((msg.kind == pubsub_kind::message));
+      chat_payload = msg.payload;
+      stop();
+   });
+
+   sub.set_handler("sub-news-*", [&](pubsub_message const& msg) {
+      BOOST_TEST((msg.kind == pubsub_kind::pmessage));
+      pattern_channel = msg.channel;
+      stop();
+   });
+
+   request publish;
+   publish.push("PUBLISH", "sub-chat", "hello");
+   publish.push("PUBLISH", "sub-news-1", "breaking");
+
+   // The PING reply guarantees the subscriptions are active before
+   // publishing.
+   request ping;
+   ping.push("PING");
+
+   sub.async_subscribe({"sub-chat"}, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      sub.async_psubscribe({"sub-news-*"}, [&](auto ec2, auto) {
+         BOOST_TEST(!ec2);
+         sub.next_layer().async_exec(ping, ignore, [&](auto ec3, auto) {
+            BOOST_TEST(!ec3);
+            pub.async_exec(publish, ignore, [](auto ec4, auto) {
+               BOOST_TEST(!ec4);
+            });
+         });
+      });
+   });
+
+   sub.async_run({}, {}, [](auto ec) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+   });
+
+   pub.async_run({}, {}, [](auto) { });
+
+   ioc.run();
+
+   BOOST_CHECK_EQUAL(chat_payload, "hello");
+   BOOST_CHECK_EQUAL(pattern_channel, "sub-news-1");
+}
+
+// With reconnection disabled the run operation of the connection
+// completes only when the connection is lost, messages must be
+// dispatched meanwhile.
+BOOST_AUTO_TEST_CASE(reconnection_disabled)
+{
+   config cfg;
+   cfg.reconnect_wait_interval = std::chrono::seconds::zero();
+
+   net::io_context ioc;
+   subscriber sub{ioc.get_executor()};
+   connection pub{ioc};
+
+   std::string payload;
+   sub.set_handler("sub-no-reconnect", [&](pubsub_message const& msg) {
+      payload = msg.payload;
+      sub.cancel();
+      pub.cancel();
+   });
+
+   request publish;
+   publish.push("PUBLISH", "sub-no-reconnect", "hello");
+
+   request ping;
+   ping.push("PING");
+
+   sub.async_subscribe({"sub-no-reconnect"}, [&](auto ec, auto) {
+      BOOST_TEST(!ec);
+      sub.next_layer().async_exec(ping, ignore, [&](auto ec2, auto) {
+         BOOST_TEST(!ec2);
+         pub.async_exec(publish, ignore, [](auto ec3, auto) {
+            BOOST_TEST(!ec3);
+         });
+      });
+   });
+
+   bool run_done = false;
+   sub.async_run(cfg, {}, [&](auto ec) {
+      BOOST_CHECK_EQUAL(ec, net::error::operation_aborted);
+      run_done = true;
+   });
+
+   pub.async_run(cfg, {}, [](auto) { });
+
+   ioc.run();
+
+   BOOST_TEST(run_done);
+   BOOST_CHECK_EQUAL(payload, "hello");
+   BOOST_CHECK_EQUAL(sub.get_messages_dispatched(), 1u);
+}
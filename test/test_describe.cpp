@@ -0,0 +1,152 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/describe.hpp>
+#include <boost/redis/adapter/adapt.hpp>
+#include <boost/redis/resp3/parser.hpp>
+#include <boost/describe.hpp>
+
+#define BOOST_TEST_MODULE describe
+#include <boost/test/included/unit_test.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace resp3 = boost::redis::resp3;
+using boost::redis::request;
+using boost::redis::push_struct;
+using boost::redis::adapter::adapt2;
+using boost::redis::adapter::result;
+using boost::redis::detail::perfect_hash;
+using boost::system::error_code;
+
+struct user {
+   std::string name;
+   int age = 0;
+   std::string country;
+};
+
+BOOST_DESCRIBE_STRUCT(user, (), (name, age, country))
+
+template <>
+struct boost::redis::is_described_struct<user> : std::true_type {};
+
+// Described but not opted in, stored in a single bulk string as in
+// cpp20_json.cpp.
+struct serialized_user {
+   std::string name;
+};
+
+BOOST_DESCRIBE_STRUCT(serialized_user, (), (name))
+
+void boost_redis_from_bulk(serialized_user& u, std::string_view sv, error_code&)
+   { u.name = sv; }
+
+template <class Response>
+void parse_one(std::string_view wire, Response& resp, error_code& ec)
+{
+   resp3::parser p;
+   auto adapter = adapt2(resp);
+   BOOST_TEST(resp3::parse(p, wire, adapter, ec));
+}
+
+BOOST_AUTO_TEST_CASE(hash_fields)
+{
+   constexpr std::array<std::string_view, 4> keys{{"name", "age", "country", "email"}};
+   constexpr perfect_hash<4> hash{keys};
+
+   static_assert(hash.find("name") == 0);
+   static_assert(hash.find("email") == 3);
+   static_assert(hash.find("other") == hash.npos);
+
+   for (std::size_t i = 0; i < keys.size(); ++i)
+      BOOST_CHECK_EQUAL(hash.find(keys[i]), i);
+
+   BOOST_CHECK_EQUAL(hash.find(""), hash.npos);
+   BOOST_CHECK_EQUAL(hash.find("nam"), hash.npos);
+
+   constexpr perfect_hash<0> empty{{}};
+   BOOST_CHECK_EQUAL(empty.find("name"), empty.npos);
+}
+
+BOOST_AUTO_TEST_CASE(hgetall)
+{
+   // Fields are in any order, unknown fields are ignored.
+   std::string_view const wire =
+      "%4\r\n"
+      "$7\r\ncountry\r\n$6\r\nBrazil\r\n"
+      "$5\r\nemail\r\n$10\r\njoao@x.com\r\n"
+      "$3\r\nage\r\n$2\r\n58\r\n"
+      "$4\r\nname\r\n$4\r\nJoao\r\n";
+
+   result<user> resp;
+   error_code ec;
+   parse_one(wire, resp, ec);
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(resp.value().name, "Joao");
+   BOOST_CHECK_EQUAL(resp.value().age, 58);
+   BOOST_CHECK_EQUAL(resp.value().country, "Brazil");
+}
+
+BOOST_AUTO_TEST_CASE(hgetall_missing_fields)
+{
+   result<std::optional<user>> resp;
+   error_code ec;
+   parse_one("%1\r\n$4\r\nname\r\n$4\r\nJoao\r\n", resp, ec);
+   BOOST_TEST(!ec);
+   BOOST_TEST(resp.value().has_value());
+   BOOST_CHECK_EQUAL(resp.value()->name, "Joao");
+   BOOST_CHECK_EQUAL(resp.value()->age, 0);
+   BOOST_TEST(resp.value()->country.empty());
+}
+
+BOOST_AUTO_TEST_CASE(hgetall_errors)
+{
+   {
+      result<user> resp;
+      error_code ec;
+      parse_one("%1\r\n$3\r\nage\r\n$3\r\nabc\r\n", resp, ec);
+      BOOST_CHECK_EQUAL(ec, boost::redis::error::not_a_number);
+   }
+
+   {
+      result<user> resp;
+      error_code ec;
+      parse_one("*1\r\n$4\r\nname\r\n", resp, ec);
+      BOOST_CHECK_EQUAL(ec, boost::redis::error::expects_resp3_map);
+   }
+
+   {
+      result<user> resp;
+      error_code ec;
+      parse_one("-ERR wrong type\r\n", resp, ec);
+      BOOST_TEST(!ec);
+      BOOST_TEST(resp.has_error());
+   }
+}
+
+BOOST_AUTO_TEST_CASE(hset)
+{
+   request req1;
+   push_struct(req1, "HSET", "user:1", user{"Joao", 58, "Brazil"});
+
+   request req2;
+   req2.push("HSET", "user:1", "name", "Joao", "age", 58, "country", "Brazil");
+
+   BOOST_CHECK_EQUAL(req1.payload(), req2.payload());
+   BOOST_CHECK_EQUAL(req1.get_commands(), 1u);
+   BOOST_CHECK_EQUAL(req1.get_expected_responses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(custom_from_bulk)
+{
+   result<serialized_user> resp;
+   error_code ec;
+   parse_one("$4\r\nJoao\r\n", resp, ec);
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(resp.value().name, "Joao");
+}
@@ -0,0 +1,181 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/logger.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/ip/address.hpp>
+
+#define BOOST_TEST_MODULE logger
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#define BOOST_REDIS_TEST_DUP _dup
+#define BOOST_REDIS_TEST_DUP2 _dup2
+#define BOOST_REDIS_TEST_CLOSE _close
+#define BOOST_REDIS_TEST_FILENO _fileno
+#else
+#include <unistd.h>
+#define BOOST_REDIS_TEST_DUP dup
+#define BOOST_REDIS_TEST_DUP2 dup2
+#define BOOST_REDIS_TEST_CLOSE close
+#define BOOST_REDIS_TEST_FILENO fileno
+#endif
+
+namespace net = boost::asio;
+using boost::redis::logger;
+using boost::redis::basic_logger;
+using boost::system::error_code;
+using endpoint = net::ip::tcp::endpoint;
+
+namespace {
+
+// Redirects stderr, where the logger writes, to a temporary file.
+class stderr_capture {
+public:
+   stderr_capture()
+   : file_{std::tmpfile()}
+   {
+      BOOST_REQUIRE(file_ != nullptr);
+      std::fflush(stderr);
+      saved_ = BOOST_REDIS_TEST_DUP(BOOST_REDIS_TEST_FILENO(stderr));
+      BOOST_REDIS_TEST_DUP2(BOOST_REDIS_TEST_FILENO(file_), BOOST_REDIS_TEST_FILENO(stderr));
+   }
+
+   ~stderr_capture()
+   {
+      std::fflush(stderr);
+      BOOST_REDIS_TEST_DUP2(saved_, BOOST_REDIS_TEST_FILENO(stderr));
+      BOOST_REDIS_TEST_CLOSE(saved_);
+      std::fclose(file_);
+   }
+
+   // Returns what has been written since the last call.
+   auto take() -> std::string
+   {
+      std::fflush(stderr);
+      std::rewind(file_);
+
+      std::string ret;
+      char buffer[256];
+      for (std::size_t n; (n = std::fread(buffer, 1, sizeof buffer, file_)) != 0;)
+         ret.append(buffer, n);
+
+      std::fclose(file_);
+      file_ = std::tmpfile();
+      BOOST_REQUIRE(file_ != nullptr);
+      BOOST_REDIS_TEST_DUP2(BOOST_REDIS_TEST_FILENO(file_), BOOST_REDIS_TEST_FILENO(stderr));
+      return ret;
+   }
+
+private:
+   std::FILE* file_;
+   int saved_;
+};
+
+// Makes every call the reader, writer and runner make.
+template <class Logger>
+void log_all(Logger& l)
+{
+   error_code const ec = net::error::connection_reset;
+   endpoint const ep{net::ip::make_address("127.0.0.1"), 6379};
+
+   l.on_connect(error_code{}, ep);
+   l.on_ssl_handshake(error_code{});
+   l.on_write(error_code{}, 42);
+   l.on_write(ec, 0);
+   l.on_read(error_code{}, 7);
+   l.on_read(ec, 0);
+   l.on_run(ec, error_code{});
+   l.on_check_health(error_code{}, ec);
+   l.on_connection_lost(ec);
+   l.on_connection_lost(error_code{});
+   l.trace("some-op: tracing.");
+}
+
+// The text the logger wrote with std::clog, before it formatted into
+// its own buffer.
+auto expected_text(std::string const& prefix) -> std::string
+{
+   error_code const ec = net::error::connection_reset;
+   endpoint const ep{net::ip::make_address("127.0.0.1"), 6379};
+
+   std::ostringstream os;
+   os << prefix << "run-all-op: connected to endpoint " << ep << std::endl;
+   os << prefix << "Runner: SSL handshake " << error_code{}.message() << std::endl;
+   os << prefix << "writer-op: " << 42 << " bytes written." << std::endl;
+   os << prefix << "writer-op: " << ec.message() << std::endl;
+   os << prefix << "reader-op: " << 7 << " bytes read." << std::endl;
+   os << prefix << "reader-op: " << ec.message() << std::endl;
+   os << prefix << "run-op: "
+      << ec.message() << " (reader), "
+      << error_code{}.message() << " (writer)" << std::endl;
+   os << prefix << "check-health-op: "
+      << error_code{}.message() << " (async_ping), "
+      << ec.message() << " (async_check_timeout)." << std::endl;
+   os << prefix << "Connection lost: " << ec.message() << std::endl;
+   os << prefix << "Connection lost." << std::endl;
+   os << prefix << "some-op: tracing." << std::endl;
+   return os.str();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(disabled_emits_nothing)
+{
+   stderr_capture cap;
+
+   basic_logger<logger::level::disabled> l1;
+   log_all(l1);
+
+   // The runtime level can't exceed the maximum.
+   basic_logger<logger::level::disabled> l2{logger::level::debug};
+   BOOST_TEST((l2.get_level() == logger::level::disabled));
+   log_all(l2);
+
+   logger l3{logger::level::disabled};
+   log_all(l3);
+
+   BOOST_CHECK_EQUAL(cap.take(), "");
+}
+
+BOOST_AUTO_TEST_CASE(max_level_drops_debug)
+{
+   stderr_capture cap;
+
+   basic_logger<logger::level::info> l{logger::level::debug};
+   l.trace("some-op: tracing.");
+   BOOST_CHECK_EQUAL(cap.take(), "");
+
+   l.on_connection_lost(error_code{});
+   BOOST_CHECK_EQUAL(cap.take(), "Connection lost.\n");
+}
+
+BOOST_AUTO_TEST_CASE(enabled_formats_as_before)
+{
+   std::string const prefix = "(conn-1) ";
+   stderr_capture cap;
+
+   logger l1{logger::level::debug};
+   l1.set_prefix(prefix);
+   log_all(l1);
+   BOOST_CHECK_EQUAL(cap.take(), expected_text(prefix));
+
+   basic_logger<logger::level::debug> l2{logger::level::debug};
+   l2.set_prefix(prefix);
+   log_all(l2);
+   BOOST_CHECK_EQUAL(cap.take(), expected_text(prefix));
+
+   // Same result when called through the base class.
+   basic_logger<logger::level::debug> l3{logger::level::debug};
+   logger& base = l3;
+   log_all(base);
+   BOOST_CHECK_EQUAL(cap.take(), expected_text(""));
+}
@@ -8,10 +8,13 @@
 #include <boost/redis/response.hpp>
 #include <boost/redis/adapter/adapt.hpp>
 #include <boost/redis/resp3/parser.hpp>
+#include <boost/redis/detail/number.hpp>
 
 #define BOOST_TEST_MODULE low level
 #include <boost/test/included/unit_test.hpp>
 
+#include <cmath>
+#include <limits>
 #include <map>
 #include <iostream>
 #include <optional>
@@ -31,6 +34,8 @@ using boost::system::error_code;
 using boost::redis::request;
 using boost::redis::response;
 using boost::redis::generic_response;
+using boost::redis::generic_flat_response;
+using boost::redis::generic_queue_response;
 using boost::redis::ignore;
 using boost::redis::ignore_t;
 using boost::redis::adapter::result;
@@ -483,6 +488,487 @@ BOOST_AUTO_TEST_CASE(ignore_adapter_no_error)
    test_sync2(make_expected(S05b, ignore));
 }
 
+BOOST_AUTO_TEST_CASE(find_separator)
+{
+   using boost::redis::resp3::detail::find_separator;
+   auto constexpr npos = std::string_view::npos;
+
+   BOOST_CHECK_EQUAL(find_separator("", 0), npos);
+   BOOST_CHECK_EQUAL(find_separator("\r", 0), npos);
+   BOOST_CHECK_EQUAL(find_separator("\n\r", 0), npos);
+   BOOST_CHECK_EQUAL(find_separator("\r\n", 0), 0u);
+   BOOST_CHECK_EQUAL(find_separator("\r\n", 1), npos);
+   BOOST_CHECK_EQUAL(find_separator("ab\r\rcd\r\n", 0), 6u);
+
+   // Places the separator at every position of a string long enough
+   // to exercise the vectorized and the scalar paths.
+   for (std::size_t i = 0; i < 100; ++i) {
+      std::string str(101, 'a');
+      str[i] = '\r';
+      str[i + 1] = '\n';
+      BOOST_CHECK_EQUAL(find_separator(str, 0), i);
+      BOOST_CHECK_EQUAL(find_separator(str, i), i);
+      BOOST_CHECK_EQUAL(find_separator(str, i + 1), npos);
+
+      // A lonely '\r' must not match.
+      str[i + 1] = 'a';
+      BOOST_CHECK_EQUAL(find_separator(str, 0), npos);
+   }
+}
+
+BOOST_AUTO_TEST_CASE(parse_incremental)
+{
+   // Feeds the parser one byte at a time to check it resumes the
+   // scan correctly, in particular when the separator is split
+   // between two reads.
+   std::string const wire = S04b;
+
+   result<std::vector<std::string>> resp;
+   auto adapter = adapt2(resp);
+
+   parser p;
+   error_code ec;
+   bool done = false;
+   for (std::size_t i = 1; i <= wire.size() && !done; ++i)
+      done = parse(p, std::string_view{wire}.substr(0, i), adapter, ec);
+
+   BOOST_TEST(done);
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(p.get_consumed(), wire.size());
+   BOOST_TEST(bool(resp == array_e1c));
+}
+
+BOOST_AUTO_TEST_CASE(parse_batch)
+{
+   std::string const wire = S03b;
+
+   std::vector<parser::node_type> nodes;
+   std::size_t calls = 0;
+   generic_response resp;
+   auto adapter = [&, a = adapt2(resp)](auto const& batch, error_code& ec) mutable
+   {
+      ++calls;
+      for (auto const& nd: batch)
+         a(nd, ec);
+   };
+
+   // The whole message at once results in a single call.
+   parser p;
+   error_code ec;
+   BOOST_TEST(parse(p, wire, nodes, adapter, ec));
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(calls, 1u);
+   BOOST_CHECK_EQUAL(p.get_consumed(), wire.size());
+   BOOST_TEST(bool(resp == map_expected_1a));
+
+   // Incomplete data delivers the nodes parsed so far.
+   parser p2;
+   BOOST_TEST(!parse(p2, std::string_view{wire}.substr(0, 20), nodes, adapter, ec));
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(calls, 2u);
+   BOOST_CHECK_EQUAL(nodes.size(), 2u);
+   BOOST_TEST(parse(p2, wire, nodes, adapter, ec));
+   BOOST_CHECK_EQUAL(calls, 3u);
+   BOOST_CHECK_EQUAL(nodes.size(), 7u);
+}
+
+BOOST_AUTO_TEST_CASE(batch_adapter)
+{
+   using boost::redis::adapter::boost_redis_adapt;
+   using boost::redis::adapter::detail::make_batch_adapter;
+   using resp3::type;
+
+   response<std::string, int> resp;
+   auto f = make_batch_adapter(boost_redis_adapt(resp));
+
+   error_code ec;
+   std::vector<parser::node_type> nodes{{type::simple_string, 1, 0, "Hello"}};
+   f(0, nodes, ec);
+   nodes = {{type::number, 1, 0, "42"}};
+   f(1, nodes, ec);
+
+   BOOST_TEST(!ec);
+   BOOST_CHECK_EQUAL(std::get<0>(resp).value(), "Hello");
+   BOOST_CHECK_EQUAL(std::get<1>(resp).value(), 42);
+}
+
+BOOST_AUTO_TEST_CASE(bulk_destination)
+{
+   using boost::redis::adapter::boost_redis_adapt;
+   using boost::redis::adapter::detail::make_batch_adapter;
+   using boost::redis::adapter::detail::any_adapter;
+
+   response<std::string, std::optional<std::string>, int> resp;
+   any_adapter adapter{make_batch_adapter(boost_redis_adapt(resp))};
+
+   BOOST_CHECK_EQUAL(adapter.get_bulk_destination(0), &std::get<0>(resp).value());
+   BOOST_TEST(!std::get<1>(resp).value().has_value());
+   auto const* dest = adapter.get_bulk_destination(1);
+   BOOST_TEST(std::get<1>(resp).value().has_value());
+   BOOST_CHECK_EQUAL(dest, &std::get<1>(resp).value().value());
+   BOOST_TEST(adapter.get_bulk_destination(2) == nullptr);
+
+   generic_response gresp;
+   any_adapter gadapter{make_batch_adapter(boost_redis_adapt(gresp))};
+   BOOST_TEST(gadapter.get_bulk_destination(0) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(parser_skip_bulk)
+{
+   std::string wire = "$10\r\n0123";
+
+   parser p;
+   error_code ec;
+   BOOST_TEST(!p.consume(wire, ec));
+   BOOST_TEST(!ec);
+   BOOST_TEST(p.get_bulk_type() == resp3::type::blob_string);
+   BOOST_CHECK_EQUAL(p.get_bulk_length(), 10u);
+   BOOST_CHECK_EQUAL(p.get_depth(), 0u);
+
+   // The content is consumed elsewhere, only the separator follows.
+   wire.erase(p.get_consumed());
+   p.skip_bulk();
+   wire += "\r\n";
+   auto const res = p.consume(wire, ec);
+   BOOST_TEST(!ec);
+   BOOST_TEST(res.has_value());
+   BOOST_TEST(res->data_type == resp3::type::blob_string);
+   BOOST_TEST(res->value.empty());
+   BOOST_TEST(p.done());
+   BOOST_CHECK_EQUAL(p.get_consumed(), wire.size());
+}
+
+BOOST_AUTO_TEST_CASE(flat_response)
+{
+   for (std::string_view wire : {S03b, S04c, S08a, S09a}) {
+      generic_response expected;
+      generic_flat_response resp;
+
+      error_code ec;
+      parser p1;
+      auto a1 = adapt2(expected);
+      BOOST_TEST(parse(p1, wire, a1, ec));
+      parser p2;
+      auto a2 = adapt2(resp);
+      BOOST_TEST(parse(p2, wire, a2, ec));
+      BOOST_TEST(!ec);
+
+      BOOST_REQUIRE_EQUAL(resp.value().size(), expected.value().size());
+      for (std::size_t i = 0; i < resp.value().size(); ++i) {
+         BOOST_TEST(resp.value()[i].data_type == expected.value()[i].data_type);
+         BOOST_CHECK_EQUAL(resp.value()[i].aggregate_size, expected.value()[i].aggregate_size);
+         BOOST_CHECK_EQUAL(resp.value()[i].depth, expected.value()[i].depth);
+         BOOST_CHECK_EQUAL(resp.value()[i].value, expected.value()[i].value);
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(flat_response_error)
+{
+   generic_flat_response resp;
+   auto adapter = adapt2(resp);
+
+   error_code ec;
+   parser p;
+   BOOST_TEST(parse(p, "-Error\r\n", adapter, ec));
+   BOOST_TEST(!ec);
+   BOOST_TEST(resp.has_error());
+   BOOST_CHECK_EQUAL(resp.error().diagnostic, "Error");
+}
+
+BOOST_AUTO_TEST_CASE(parse_integer)
+{
+   using boost::redis::detail::parse_integer;
+
+   std::uint64_t u = 0;
+   BOOST_TEST(parse_integer(u, "0"));
+   BOOST_CHECK_EQUAL(u, 0u);
+   BOOST_TEST(parse_integer(u, "1234567"));
+   BOOST_CHECK_EQUAL(u, 1234567u);
+   BOOST_TEST(parse_integer(u, "18446744073709551615"));
+   BOOST_CHECK_EQUAL(u, 18446744073709551615ull);
+   BOOST_TEST(!parse_integer(u, "18446744073709551616"));
+   BOOST_TEST(!parse_integer(u, ""));
+   BOOST_TEST(!parse_integer(u, "-1"));
+   BOOST_TEST(!parse_integer(u, "12a"));
+   BOOST_TEST(!parse_integer(u, "+1"));
+
+   int i = 0;
+   BOOST_TEST(parse_integer(i, "-42"));
+   BOOST_CHECK_EQUAL(i, -42);
+   BOOST_TEST(parse_integer(i, "-2147483648"));
+   BOOST_CHECK_EQUAL(i, (std::numeric_limits<int>::min)());
+   BOOST_TEST(parse_integer(i, "2147483647"));
+   BOOST_CHECK_EQUAL(i, (std::numeric_limits<int>::max)());
+   BOOST_TEST(!parse_integer(i, "2147483648"));
+   BOOST_TEST(!parse_integer(i, "-"));
+
+   std::int64_t l = 0;
+   BOOST_TEST(parse_integer(l, "-9223372036854775808"));
+   BOOST_CHECK_EQUAL(l, (std::numeric_limits<std::int64_t>::min)());
+   BOOST_TEST(!parse_integer(l, "9223372036854775808"));
+}
+
+BOOST_AUTO_TEST_CASE(parse_double)
+{
+   using boost::redis::detail::parse_double;
+
+   auto const check = [](std::string_view sv, double expected)
+   {
+      double d = 0;
+      BOOST_TEST(parse_double(d, sv), sv);
+      BOOST_CHECK_EQUAL(d, expected);
+   };
+
+   check("0", 0.0);
+   check("1.23", 1.23);
+   check("-1.23", -1.23);
+   check("+1.23", 1.23);
+   check("0.0012", 0.0012);
+   check("3.1415926535897931", 3.1415926535897931);
+   check("1e10", 1e10);
+   check("1.5E-3", 1.5e-3);
+   check("123456789012345678901234567890", 123456789012345678901234567890.0);
+   check("1e300", 1e300);
+   check("4.9406564584124654e-324", 4.9406564584124654e-324);
+   check("inf", std::numeric_limits<double>::infinity());
+   check("-inf", -std::numeric_limits<double>::infinity());
+
+   double d = 0;
+   BOOST_TEST(parse_double(d, "nan"));
+   BOOST_TEST(std::isnan(d));
+   BOOST_TEST(parse_double(d, "-0"));
+   BOOST_TEST(std::signbit(d));
+
+   BOOST_TEST(!parse_double(d, ""));
+   BOOST_TEST(!parse_double(d, "er"));
+   BOOST_TEST(!parse_double(d, "1.2.3"));
+   BOOST_TEST(!parse_double(d, "1e"));
+   BOOST_TEST(!parse_double(d, "."));
+   BOOST_TEST(!parse_double(d, "-"));
+}
+
+#ifdef BOOST_REDIS_HAS_MEMORY_RESOURCE
+BOOST_AUTO_TEST_CASE(pmr_adapters)
+{
+   // Values larger than the small string buffer.
+   std::string const key(32, 'k');
+   std::string const key2(32, 'l');
+   std::string const value(64, 'v');
+   std::string const wire =
+      "%2\r\n"
+      "$32\r\n" + key + "\r\n$64\r\n" + value + "\r\n"
+      "$32\r\n" + key2 + "\r\n$64\r\n" + value + "\r\n";
+
+   // Anything allocated outside of the buffer throws.
+   alignas(std::max_align_t) std::array<unsigned char, 16384> buffer;
+   std::pmr::monotonic_buffer_resource mr{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+   auto* const previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+   using map_type = std::pmr::map<std::pmr::string, std::pmr::string>;
+   using vector_type = std::pmr::vector<std::pmr::string>;
+   using set_type = std::pmr::set<std::pmr::string>;
+
+   result<map_type> map{map_type{&mr}};
+   result<vector_type> vec{vector_type{&mr}};
+   result<set_type> set{set_type{&mr}};
+   redis::pmr::generic_response gen{std::pmr::vector<resp3::pmr::node>{&mr}};
+
+   error_code ec;
+   parser p1;
+   auto a1 = adapt2(map);
+   BOOST_TEST(parse(p1, wire, a1, ec));
+   parser p2;
+   auto a2 = adapt2(vec);
+   BOOST_TEST(parse(p2, wire, a2, ec));
+   parser p3;
+   auto a3 = adapt2(gen);
+   BOOST_TEST(parse(p3, wire, a3, ec));
+   parser p4;
+   auto a4 = adapt2(set);
+   BOOST_TEST(parse(p4, "~2\r\n$32\r\n" + key + "\r\n$64\r\n" + value + "\r\n", a4, ec));
+
+   std::pmr::set_default_resource(previous);
+   BOOST_TEST(!ec);
+
+   BOOST_REQUIRE_EQUAL(map.value().size(), 2u);
+   BOOST_CHECK_EQUAL(std::string_view{map.value().begin()->first}, key);
+   BOOST_CHECK_EQUAL(std::string_view{map.value().begin()->second}, value);
+   BOOST_TEST(map.value().begin()->second.get_allocator().resource() == &mr);
+
+   BOOST_REQUIRE_EQUAL(vec.value().size(), 4u);
+   BOOST_CHECK_EQUAL(std::string_view{vec.value()[3]}, value);
+   BOOST_TEST(vec.value()[3].get_allocator().resource() == &mr);
+
+   BOOST_REQUIRE_EQUAL(gen.value().size(), 5u);
+   BOOST_CHECK_EQUAL(std::string_view{gen.value()[1].value}, key);
+   BOOST_TEST(gen.value()[1].value.get_allocator().resource() == &mr);
+
+   BOOST_REQUIRE_EQUAL(set.value().size(), 2u);
+}
+#endif // BOOST_REDIS_HAS_MEMORY_RESOURCE
+
+BOOST_AUTO_TEST_CASE(flat_tree_reallocation)
+{
+   resp3::flat_tree tree;
+   std::vector<std::string> values;
+   for (int i = 0; i < 1000; ++i) {
+      values.push_back(std::to_string(i));
+      tree.push_back({resp3::type::blob_string, 1, 1, values.back()});
+      tree.push_back({resp3::type::array, 0, 1, {}});
+   }
+
+   BOOST_REQUIRE_EQUAL(tree.size(), 2000u);
+   for (std::size_t i = 0; i < values.size(); ++i) {
+      BOOST_CHECK_EQUAL(tree[2 * i].value, values[i]);
+      BOOST_TEST(tree[2 * i + 1].value.empty());
+   }
+
+   auto const data_size = tree.get_data_size();
+   tree.clear();
+   BOOST_TEST(tree.empty());
+   BOOST_CHECK_EQUAL(tree.get_data_size(), 0u);
+
+   tree.reserve(10, 2 * data_size);
+   tree.push_back({resp3::type::simple_string, 1, 0, "PONG"});
+   BOOST_CHECK_EQUAL(tree.front().value, "PONG");
+   BOOST_TEST(tree == tree);
+}
+
+// Copies and moves must not point into the buffer of the source.
+// The values fit in the small string buffer, which is moved by
+// copying, and the sources are overwritten afterwards.
+BOOST_AUTO_TEST_CASE(flat_tree_copy_move)
+{
+   std::vector<std::string> const values{"a", "bc", "def"};
+
+   auto const fill = [](resp3::flat_tree& tree, std::vector<std::string> const& vs) {
+      tree.clear();
+      tree.push_back({resp3::type::array, vs.size(), 0, {}});
+      for (auto const& v: vs)
+         tree.push_back({resp3::type::blob_string, 1, 1, v});
+   };
+
+   auto const check = [&](resp3::flat_tree const& tree) {
+      BOOST_REQUIRE_EQUAL(tree.size(), 4u);
+      BOOST_TEST(tree[0].value.empty());
+      for (std::size_t i = 0; i < values.size(); ++i)
+         BOOST_CHECK_EQUAL(tree[i + 1].value, values[i]);
+   };
+
+   std::vector<std::string> const other{"x", "yz", "uvw"};
+
+   resp3::flat_tree src;
+   fill(src, values);
+   resp3::flat_tree copy{src};
+   resp3::flat_tree assigned;
+   assigned = src;
+   fill(src, other);
+   check(copy);
+   check(assigned);
+
+   fill(src, values);
+   resp3::flat_tree moved{std::move(src)};
+   BOOST_TEST(src.empty());
+   fill(src, other);
+   check(moved);
+
+   fill(src, values);
+   resp3::flat_tree move_assigned;
+   move_assigned = std::move(src);
+   fill(src, other);
+   check(move_assigned);
+
+   BOOST_TEST(copy == move_assigned);
+}
+
+BOOST_AUTO_TEST_CASE(queue_response_consume_one)
+{
+   std::string_view const wire =
+      ">3\r\n$7\r\nmessage\r\n$2\r\nch\r\n$3\r\none\r\n"
+      "+PONG\r\n"
+      ">3\r\n$7\r\nmessage\r\n$2\r\nch\r\n$3\r\ntwo\r\n";
+
+   generic_queue_response resp;
+   auto adapter = adapt2(resp);
+
+   error_code ec;
+   for (std::string_view w = wire; !w.empty();) {
+      parser p;
+      BOOST_TEST(parse(p, w, adapter, ec));
+      BOOST_TEST(!ec);
+      w.remove_prefix(p.get_consumed());
+   }
+
+   BOOST_CHECK_EQUAL(resp.value().size(), 9u);
+   BOOST_CHECK_EQUAL(resp.value().get_messages(), 3u);
+   BOOST_CHECK_EQUAL(resp.value().get_front_size(), 4u);
+   BOOST_CHECK_EQUAL(resp.value().at(3).value, "one");
+
+   consume_one(resp);
+   BOOST_CHECK_EQUAL(resp.value().size(), 5u);
+   BOOST_CHECK_EQUAL(resp.value().front().value, "PONG");
+
+   consume_one(resp);
+   BOOST_CHECK_EQUAL(resp.value().at(3).value, "two");
+   BOOST_CHECK_THROW(std::ignore = resp.value().at(4), std::out_of_range);
+
+   consume_one(resp);
+   BOOST_TEST(resp.value().empty());
+   BOOST_CHECK_EQUAL(resp.value().get_messages(), 0u);
+
+   // Consuming an empty queue has no effect.
+   consume_one(resp);
+   BOOST_TEST(resp.value().empty());
+}
+
+BOOST_AUTO_TEST_CASE(queue_response_error)
+{
+   generic_queue_response resp;
+   auto adapter = adapt2(resp);
+
+   error_code ec;
+   parser p;
+   BOOST_TEST(parse(p, "-Error\r\n", adapter, ec));
+   BOOST_TEST(!ec);
+   BOOST_TEST(resp.has_error());
+
+   consume_one(resp);
+   BOOST_TEST(resp.has_error());
+}
+
+BOOST_AUTO_TEST_CASE(node_queue_wrap_around)
+{
+   resp3::node_queue q;
+
+   // Interleaves pushes and pops so that messages wrap around the
+   // end of the buffer and the buffer grows while wrapped.
+   std::size_t pushed = 0;
+   std::size_t popped = 0;
+   for (int round = 0; round < 50; ++round) {
+      for (int i = 0; i < 3; ++i) {
+         auto const value = std::to_string(pushed++);
+         q.push_back(resp3::basic_node<std::string_view>{resp3::type::array, 1, 0, {}});
+         q.push_back(resp3::basic_node<std::string_view>{resp3::type::blob_string, 1, 1, value});
+      }
+
+      for (int i = 0; i < 2; ++i) {
+         BOOST_REQUIRE_EQUAL(q.get_front_size(), 2u);
+         BOOST_CHECK_EQUAL(q[1].value, std::to_string(popped++));
+         q.pop_front();
+      }
+   }
+
+   BOOST_CHECK_EQUAL(q.get_messages(), pushed - popped);
+   BOOST_CHECK_EQUAL(q.size(), 2 * (pushed - popped));
+   for (std::size_t i = 0; i < q.get_messages(); ++i)
+      BOOST_CHECK_EQUAL(q[2 * i + 1].value, std::to_string(popped + i));
+
+   q.clear();
+   BOOST_TEST(q.empty());
+   BOOST_CHECK_EQUAL(q.get_front_size(), 0u);
+}
+
 //-----------------------------------------------------------------------------------
 void check_error(char const* name, boost::redis::error ev)
 {
@@ -0,0 +1,129 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/metrics.hpp>
+#include <boost/redis/request.hpp>
+
+#define BOOST_TEST_MODULE metrics
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <string>
+
+using boost::redis::request;
+using boost::redis::latency_metrics;
+using boost::redis::histogram_snapshot;
+using boost::redis::detail::latency_histogram;
+using boost::redis::detail::next_command;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(histogram_buckets)
+{
+   // Buckets are contiguous and increasing.
+   for (std::size_t i = 1; i < latency_histogram::size; ++i) {
+      auto const lower = latency_histogram::lower_bound(i);
+      BOOST_TEST(lower > latency_histogram::lower_bound(i - 1));
+      BOOST_CHECK_EQUAL(latency_histogram::index_of(lower), i);
+      BOOST_CHECK_EQUAL(latency_histogram::index_of(lower - 1), i - 1);
+   }
+
+   BOOST_CHECK_EQUAL(latency_histogram::index_of(0), 0u);
+   BOOST_CHECK_EQUAL(latency_histogram::index_of(31), 31u);
+   BOOST_CHECK_EQUAL(latency_histogram::index_of(std::uint64_t{1} << 40), latency_histogram::size - 1);
+}
+
+BOOST_AUTO_TEST_CASE(histogram_percentiles)
+{
+   latency_histogram h;
+   for (int i = 1; i <= 1000; ++i)
+      h.record(std::chrono::microseconds(i));
+
+   histogram_snapshot s;
+   h.snapshot(s);
+
+   BOOST_CHECK_EQUAL(s.count, 1000u);
+   BOOST_CHECK_EQUAL(s.max.count(), 1000000);
+   BOOST_CHECK_EQUAL(s.mean().count(), 500500);
+
+   // Within the 1/32 bucket width.
+   auto const check = [&](double p, std::chrono::nanoseconds expected)
+   {
+      auto const v = s.percentile(p);
+      BOOST_TEST(v >= expected);
+      BOOST_TEST(v.count() <= expected.count() + expected.count() / 32);
+   };
+
+   check(0.5, 500us);
+   check(0.9, 900us);
+   check(0.99, 990us);
+   BOOST_CHECK_EQUAL(s.percentile(1.0).count(), s.max.count());
+   BOOST_CHECK_EQUAL(histogram_snapshot{}.percentile(0.5).count(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(command_names)
+{
+   request req;
+   req.push("HELLO", 3);
+   req.push("SUBSCRIBE", "channel");
+   req.push_range("RPUSH", "key", std::vector<std::string>{"a\r\nb", ""});
+
+   std::size_t pos = 0;
+   BOOST_CHECK_EQUAL(next_command(req.payload(), pos), "HELLO");
+   BOOST_CHECK_EQUAL(next_command(req.payload(), pos), "SUBSCRIBE");
+   BOOST_CHECK_EQUAL(next_command(req.payload(), pos), "RPUSH");
+   BOOST_CHECK_EQUAL(pos, req.payload().size());
+   BOOST_TEST(next_command(req.payload(), pos).empty());
+
+   pos = 0;
+   BOOST_TEST(next_command("*1\r\n$5\r\nPI", pos).empty());
+}
+
+BOOST_AUTO_TEST_CASE(per_command)
+{
+   latency_metrics m;
+   m.record_command("get", 10us);
+   m.record_command("GET", 30us);
+   m.record_command("SET", 5us);
+
+   auto const s = m.snapshot();
+   BOOST_REQUIRE_EQUAL(s.commands.size(), 2u);
+   BOOST_CHECK_EQUAL(s.commands[0].name, "GET");
+   BOOST_CHECK_EQUAL(s.commands[0].count, 2u);
+   BOOST_TEST(s.commands[0].total == 40us);
+   BOOST_TEST(s.commands[0].max == 30us);
+   BOOST_CHECK_EQUAL(s.commands[1].name, "SET");
+}
+
+BOOST_AUTO_TEST_CASE(per_command_overflow)
+{
+   latency_metrics m;
+   for (std::size_t i = 0; i < latency_metrics::max_commands + 10; ++i)
+      m.record_command("CMD" + std::to_string(i), 1us);
+
+   m.record_command(std::string(latency_metrics::max_command_size + 1, 'A'), 1us);
+
+   auto const s = m.snapshot();
+   BOOST_REQUIRE_EQUAL(s.commands.size(), latency_metrics::max_commands + 1);
+   BOOST_CHECK_EQUAL(s.commands.back().name, "*");
+   BOOST_CHECK_EQUAL(s.commands.back().count, 11u);
+}
+
+BOOST_AUTO_TEST_CASE(high_water_marks)
+{
+   latency_metrics m;
+   m.on_exec();
+   m.on_exec();
+   m.on_done();
+   m.on_exec();
+   m.on_done();
+   m.on_done();
+   m.on_staged(3);
+   m.on_staged(1);
+
+   auto const s = m.snapshot();
+   BOOST_CHECK_EQUAL(s.max_pending_requests, 2u);
+   BOOST_CHECK_EQUAL(s.max_write_batch, 3u);
+}
@@ -0,0 +1,96 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/pubsub.hpp>
+#include <boost/redis/resp3/parser.hpp>
+
+#define BOOST_TEST_MODULE pubsub
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+#include <string_view>
+
+namespace resp3 = boost::redis::resp3;
+using boost::redis::adapter::boost_redis_adapt;
+using boost::redis::adapter::detail::make_adapter_wrapper;
+using boost::redis::detail::pubsub_queue;
+using boost::redis::pubsub_kind;
+using boost::system::error_code;
+
+void parse_all(std::string_view wire, pubsub_queue& q)
+{
+   auto adapter = make_adapter_wrapper(boost_redis_adapt(q));
+   while (!wire.empty()) {
+      error_code ec;
+      resp3::parser p;
+      auto const ok = resp3::parse(p, wire, adapter, ec);
+      BOOST_TEST(ok);
+      BOOST_TEST(!ec);
+      wire.remove_prefix(p.get_consumed());
+   }
+}
+
+BOOST_AUTO_TEST_CASE(messages)
+{
+   std::string_view const wire =
+      ">3\r\n$7\r\nmessage\r\n$4\r\nchat\r\n$5\r\nhello\r\n"
+      ">4\r\n$8\r\npmessage\r\n$2\r\nc*\r\n$4\r\nchat\r\n$3\r\nbye\r\n"
+      ">3\r\n$8\r\nsmessage\r\n$5\r\nshard\r\n$0\r\n\r\n";
+
+   pubsub_queue q;
+   parse_all(wire, q);
+
+   BOOST_CHECK_EQUAL(q.size, 3u);
+
+   BOOST_TEST((q.messages.at(0).kind == pubsub_kind::message));
+   BOOST_CHECK_EQUAL(q.messages.at(0).pattern, "");
+   BOOST_CHECK_EQUAL(q.messages.at(0).channel, "chat");
+   BOOST_CHECK_EQUAL(q.messages.at(0).payload, "hello");
+
+   BOOST_TEST((q.messages.at(1).kind == pubsub_kind::pmessage));
+   BOOST_CHECK_EQUAL(q.messages.at(1).pattern, "c*");
+   BOOST_CHECK_EQUAL(q.messages.at(1).channel, "chat");
+   BOOST_CHECK_EQUAL(q.messages.at(1).payload, "bye");
+
+   BOOST_TEST((q.messages.at(2).kind == pubsub_kind::smessage));
+   BOOST_CHECK_EQUAL(q.messages.at(2).channel, "shard");
+   BOOST_CHECK_EQUAL(q.messages.at(2).payload, "");
+}
+
+BOOST_AUTO_TEST_CASE(other_pushes_are_skipped)
+{
+   std::string_view const wire =
+      ">3\r\n$9\r\nsubscribe\r\n$4\r\nchat\r\n:1\r\n"
+      ">2\r\n$10\r\ninvalidate\r\n*1\r\n$3\r\nkey\r\n"
+      ">3\r\n$7\r\nmessage\r\n$4\r\nchat\r\n$5\r\nhello\r\n";
+
+   pubsub_queue q;
+   parse_all(wire, q);
+
+   BOOST_CHECK_EQUAL(q.size, 1u);
+   BOOST_CHECK_EQUAL(q.messages.at(0).channel, "chat");
+   BOOST_CHECK_EQUAL(q.messages.at(0).payload, "hello");
+}
+
+BOOST_AUTO_TEST_CASE(messages_are_reused)
+{
+   std::string_view const wire =
+      ">4\r\n$8\r\npmessage\r\n$2\r\nc*\r\n$4\r\nchat\r\n$3\r\nbye\r\n";
+
+   pubsub_queue q;
+   parse_all(wire, q);
+   BOOST_CHECK_EQUAL(q.size, 1u);
+
+   q.clear();
+   parse_all(">3\r\n$7\r\nmessage\r\n$1\r\na\r\n$1\r\nb\r\n", q);
+
+   BOOST_CHECK_EQUAL(q.size, 1u);
+   BOOST_CHECK_EQUAL(q.messages.size(), 1u);
+   BOOST_TEST((q.messages.at(0).kind == pubsub_kind::message));
+   BOOST_CHECK_EQUAL(q.messages.at(0).pattern, "");
+   BOOST_CHECK_EQUAL(q.messages.at(0).channel, "a");
+   BOOST_CHECK_EQUAL(q.messages.at(0).payload, "b");
+}
@@ -0,0 +1,103 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/replication.hpp>
+#include <boost/redis/detail/rtt.hpp>
+
+#define BOOST_TEST_MODULE replication
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using boost::redis::request;
+using boost::redis::detail::replica_info;
+using boost::redis::detail::smoothed_rtt;
+using namespace std::chrono_literals;
+
+BOOST_AUTO_TEST_CASE(read_only_commands)
+{
+   using boost::redis::detail::is_read_only_command;
+
+   BOOST_TEST(is_read_only_command("GET"));
+   BOOST_TEST(is_read_only_command("get"));
+   BOOST_TEST(is_read_only_command("HGETALL"));
+   BOOST_TEST(is_read_only_command("ZUNION"));
+   BOOST_TEST(is_read_only_command("BITCOUNT"));
+   BOOST_TEST(!is_read_only_command("SET"));
+   BOOST_TEST(!is_read_only_command("GETDEL"));
+   BOOST_TEST(!is_read_only_command("EVAL"));
+   BOOST_TEST(!is_read_only_command(""));
+}
+
+BOOST_AUTO_TEST_CASE(read_only_requests)
+{
+   using boost::redis::detail::is_read_only;
+
+   request req;
+   BOOST_TEST(!is_read_only(req));
+
+   req.push("GET", "key");
+   req.push("HGETALL", "hash");
+   req.push("MGET", "a", "b", "c");
+   BOOST_TEST(is_read_only(req));
+
+   // Arguments are not taken for commands.
+   req.push("EXISTS", "SET");
+   BOOST_TEST(is_read_only(req));
+
+   req.push("SET", "key", "value");
+   BOOST_TEST(!is_read_only(req));
+}
+
+BOOST_AUTO_TEST_CASE(info_replication)
+{
+   std::string const info =
+      "# Replication\r\n"
+      "role:master\r\n"
+      "connected_slaves:2\r\n"
+      "slave0:ip=127.0.0.1,port=6380,state=online,offset=1200,lag=0\r\n"
+      "slave1:ip=10.0.0.2,port=6381,state=wait_bgsave,offset=0,lag=12\r\n"
+      "master_failover_state:no-failover\r\n"
+      "master_repl_offset:1234\r\n";
+
+   std::size_t offset = 0;
+   std::vector<replica_info> replicas;
+   boost::redis::detail::parse_info_replication(info, offset, replicas);
+
+   BOOST_CHECK_EQUAL(offset, 1234u);
+   BOOST_CHECK_EQUAL(replicas.size(), 2u);
+
+   BOOST_CHECK_EQUAL(replicas.at(0).addr.host, "127.0.0.1");
+   BOOST_CHECK_EQUAL(replicas.at(0).addr.port, "6380");
+   BOOST_TEST(replicas.at(0).online);
+   BOOST_CHECK_EQUAL(replicas.at(0).offset, 1200u);
+   BOOST_CHECK_EQUAL(replicas.at(0).lag, 0u);
+
+   BOOST_CHECK_EQUAL(replicas.at(1).addr.host, "10.0.0.2");
+   BOOST_TEST(!replicas.at(1).online);
+   BOOST_CHECK_EQUAL(replicas.at(1).lag, 12u);
+}
+
+BOOST_AUTO_TEST_CASE(rtt_smoothing)
+{
+   smoothed_rtt rtt;
+   BOOST_TEST((rtt.value() == 0ms));
+
+   // A first sample of zero is still the first sample.
+   rtt.update(0ms);
+   BOOST_TEST((rtt.value() == 0ms));
+
+   rtt.update(80ms);
+   BOOST_TEST((rtt.value() == 10ms));
+
+   smoothed_rtt other;
+   other.update(16ms);
+   BOOST_TEST((other.value() == 16ms));
+   other.update(0ms);
+   BOOST_TEST((other.value() == 14ms));
+}
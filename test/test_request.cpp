@@ -51,3 +51,65 @@ BOOST_AUTO_TEST_CASE(container_and_range)
    req2.push_range("HSET", "key", std::cbegin(in), std::cend(in));
    BOOST_CHECK_EQUAL(req2.payload(), std::string{res});
 }
+
+BOOST_AUTO_TEST_CASE(static_command)
+{
+   using boost::redis::make_command;
+
+   constexpr auto set_cmd = make_command<4>("SET");
+   static_assert(set_cmd.get_name() == "SET");
+   static_assert(set_cmd.get_prefix() == "*5\r\n$3\r\nSET\r\n");
+
+   request req1;
+   req1.push(set_cmd, "key", "value", "EX", 2);
+
+   request req2;
+   req2.push("SET", "key", "value", "EX", 2);
+
+   BOOST_CHECK_EQUAL(req1.payload(), req2.payload());
+   BOOST_CHECK_EQUAL(req1.get_commands(), 1u);
+   BOOST_CHECK_EQUAL(req1.get_expected_responses(), 1u);
+
+   constexpr auto ping_cmd = make_command<0>("PING");
+   request req3;
+   req3.push(ping_cmd);
+   BOOST_CHECK_EQUAL(req3.payload(), std::string{"*1\r\n$4\r\nPING\r\n"});
+
+   constexpr auto subscribe_cmd = make_command<1>("SUBSCRIBE");
+   request req4;
+   req4.push(subscribe_cmd, "channel");
+   BOOST_CHECK_EQUAL(req4.get_expected_responses(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(arg_integers)
+{
+   request req;
+   req.push("CMD", -42, 0, true, 18446744073709551615ull, static_cast<short>(7));
+   BOOST_CHECK_EQUAL(req.payload(), std::string{"*6\r\n$3\r\nCMD\r\n$3\r\n-42\r\n$1\r\n0\r\n$1\r\n1\r\n$20\r\n18446744073709551615\r\n$1\r\n7\r\n"});
+}
+
+BOOST_AUTO_TEST_CASE(external_buffer)
+{
+   std::string buffer;
+   buffer.reserve(1024);
+   buffer = "garbage";
+   auto const* data = static_cast<void const*>(buffer.data());
+   auto const capacity = buffer.capacity();
+
+   request req;
+   req.set_buffer(std::move(buffer));
+   BOOST_TEST(req.payload().empty());
+   BOOST_CHECK_EQUAL(req.get_commands(), 0u);
+
+   req.push("SET", "key", "value");
+   BOOST_CHECK_EQUAL(static_cast<void const*>(req.payload().data()), data);
+   BOOST_CHECK_EQUAL(req.get_commands(), 1u);
+
+   buffer = req.release_buffer();
+   BOOST_TEST(buffer.empty());
+   BOOST_CHECK_EQUAL(static_cast<void const*>(buffer.data()), data);
+   BOOST_CHECK_EQUAL(buffer.capacity(), capacity);
+   BOOST_TEST(req.payload().empty());
+   BOOST_CHECK_EQUAL(req.get_commands(), 0u);
+   BOOST_CHECK_EQUAL(req.get_expected_responses(), 0u);
+}
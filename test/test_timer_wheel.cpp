@@ -0,0 +1,133 @@
+/* Copyright (c) 2018-2023 Marcelo Zimbres Silva (mzimbres@gmail.com)
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt)
+ */
+
+#include <boost/redis/detail/timer_wheel.hpp>
+
+#define BOOST_TEST_MODULE timer-wheel
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using boost::redis::detail::timer_wheel;
+using boost::redis::detail::timer_wheel_node;
+using clock_type = timer_wheel::clock_type;
+using namespace std::chrono_literals;
+
+struct timer : timer_wheel_node {
+   clock_type::time_point deadline;
+   int fired = 0;
+};
+
+BOOST_AUTO_TEST_CASE(expires_in_order)
+{
+   auto const origin = clock_type::now();
+   timer_wheel wheel{origin};
+
+   std::vector<timer> timers(3);
+   timers[0].deadline = origin + 5ms;
+   timers[1].deadline = origin + 2s;
+   timers[2].deadline = origin + 1500us;
+
+   for (auto& t: timers)
+      wheel.schedule(t, t.deadline);
+
+   BOOST_CHECK_EQUAL(wheel.size(), 3u);
+   BOOST_TEST((wheel.next_expiry() <= timers[2].deadline + 1ms));
+
+   std::vector<timer*> fired;
+   auto const f = [&](timer_wheel_node& n) { fired.push_back(static_cast<timer*>(&n)); };
+
+   wheel.advance(origin + 1ms, f);
+   BOOST_TEST(fired.empty());
+
+   wheel.advance(origin + 10ms, f);
+   BOOST_REQUIRE_EQUAL(fired.size(), 2u);
+   BOOST_TEST(fired[0] == &timers[2]);
+   BOOST_TEST(fired[1] == &timers[0]);
+
+   wheel.advance(origin + 3s, f);
+   BOOST_REQUIRE_EQUAL(fired.size(), 3u);
+   BOOST_TEST(fired[2] == &timers[1]);
+   BOOST_TEST(wheel.empty());
+   BOOST_TEST((wheel.next_expiry() == (clock_type::time_point::max)()));
+}
+
+BOOST_AUTO_TEST_CASE(cancel)
+{
+   auto const origin = clock_type::now();
+   timer_wheel wheel{origin};
+
+   timer t1;
+   timer t2;
+   wheel.schedule(t1, origin + 10ms);
+   wheel.schedule(t2, origin + 10min);
+   wheel.cancel(t1);
+   wheel.cancel(t1);
+
+   BOOST_TEST(!t1.is_scheduled());
+   BOOST_CHECK_EQUAL(wheel.size(), 1u);
+
+   int n = 0;
+   wheel.advance(origin + 1h, [&](auto&) { ++n; });
+   BOOST_CHECK_EQUAL(n, 1);
+   BOOST_TEST(!t2.is_scheduled());
+}
+
+// Random deadlines, including past ones and beyond the range of the
+// wheel, expire at the first advance that reaches them.
+BOOST_AUTO_TEST_CASE(random_deadlines)
+{
+   auto const origin = clock_type::now();
+   timer_wheel wheel{origin};
+
+   std::mt19937_64 gen{42};
+   std::uniform_int_distribution<std::int64_t> range{-10, 6 * 3600 * 1000};
+   std::uniform_int_distribution<std::int64_t> step{0, 200000};
+
+   std::vector<timer> timers(2000);
+   for (auto& t: timers) {
+      // Mostly short deadlines.
+      auto const ms = range(gen) % ((gen() % 4 == 0) ? 6 * 3600 * 1000 : 5000);
+      t.deadline = origin + std::chrono::milliseconds{ms};
+      wheel.schedule(t, t.deadline);
+   }
+
+   auto now = origin;
+   auto const end = origin + 7h;
+   for (std::size_t i = 0; now < end; ++i) {
+      auto const next = wheel.next_expiry();
+
+      // Checks next_expiry is not after the first deadline, at most
+      // one tick later due to rounding.
+      if (i % 1000 == 0) {
+         auto first = (clock_type::time_point::max)();
+         for (auto const& t: timers) {
+            if (t.is_scheduled())
+               first = (std::min)(first, t.deadline);
+         }
+
+         BOOST_TEST((first == (clock_type::time_point::max)() || next <= first + 1ms));
+      }
+
+      auto const prev = now;
+      now = (std::min)(now + std::chrono::microseconds{step(gen)}, next);
+
+      wheel.advance(now, [&](timer_wheel_node& n) {
+         auto& t = static_cast<timer&>(n);
+         ++t.fired;
+         BOOST_TEST((t.deadline <= now));
+         BOOST_TEST((t.deadline + 1ms > prev));
+      });
+   }
+
+   for (auto const& t: timers)
+      BOOST_CHECK_EQUAL(t.fired, 1);
+
+   BOOST_TEST(wheel.empty());
+}